@@ -0,0 +1,38 @@
+#include "Benchmark.h"
+#include <iostream>
+#include "DellacherieHeuristic.h"
+#include "HeuristicStrategy.h"
+
+namespace TetrisAI {
+
+	int allocationBenchmark(const BenchmarkSettings& settings)
+	{
+		std::cout << "depth\tmoves\tfirst move allocs\tallocs/move (next moves)\tseconds/move (next moves)" << std::endl;
+		for (auto depth : settings.depths)
+		{
+			DellacherieHeuristic heuristic;
+			HeuristicStrategy strategy(heuristic, depth, settings.useMultithreading);
+			std::vector<MoveMeasure> measures(measureMoves(settings, strategy));
+			if (measures.empty())
+			{
+				continue;
+			}
+
+			// The first decision builds the whole tree while the next ones only build a new level: they are reported separately
+			unsigned long long allocations(0);
+			double seconds(0);
+			for (unsigned i = 1; i < measures.size(); i++)
+			{
+				allocations += measures[i].allocations;
+				seconds += measures[i].seconds;
+			}
+			unsigned nextMoves(measures.size() - 1);
+
+			std::cout << depth << "\t" << measures.size() << "\t" << measures[0].allocations << "\t"
+				<< (nextMoves ? allocations / nextMoves : 0) << "\t"
+				<< (nextMoves ? seconds / nextMoves : 0) << std::endl;
+		}
+		return 0;
+	}
+
+}
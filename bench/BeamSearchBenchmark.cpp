@@ -0,0 +1,50 @@
+#include "Benchmark.h"
+#include <iostream>
+#include "HeuristicStrategy.h"
+#include "BeamSearchStrategy.h"
+
+namespace TetrisAI {
+
+	namespace {
+		void reportMoves(const std::string& strategyName, unsigned int depth, const std::vector<MoveMeasure>& measures, const CountingHeuristic& heuristic)
+		{
+			double seconds(0);
+			int lines(0);
+			for (auto& measure : measures)
+			{
+				seconds += measure.seconds;
+				lines += measure.linesCleared;
+			}
+
+			std::cout << depth << "\t" << strategyName << "\t" << measures.size() << "\t" << lines << "\t" << heuristic.evaluations << "\t"
+				<< seconds << "\t" << (seconds > 0 ? heuristic.evaluations / seconds : 0) << std::endl;
+		}
+	}
+
+	int beamSearchBenchmark(const BenchmarkSettings& settings)
+	{
+		std::cout << "depth\tstrategy\tmoves\tlines cleared\tevaluated nodes\tseconds\tnodes/second" << std::endl;
+		for (auto depth : settings.depths)
+		{
+			// Decision trees cannot consider as many moves as beams
+			if (depth <= HeuristicStrategy::maxDepth)
+			{
+				CountingHeuristic heuristic;
+				HeuristicStrategy strategy(heuristic, depth, settings.useMultithreading);
+				reportMoves("tree", depth, measureMoves(settings, strategy), heuristic);
+			}
+
+			for (unsigned int width : { 16, 64 })
+			{
+				if (depth <= BeamSearchStrategy::maxDepth)
+				{
+					CountingHeuristic heuristic;
+					BeamSearchStrategy strategy(heuristic, depth, width, 0, settings.seed);
+					reportMoves("beam " + std::to_string(width), depth, measureMoves(settings, strategy), heuristic);
+				}
+			}
+		}
+		return 0;
+	}
+
+}
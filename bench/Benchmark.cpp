@@ -0,0 +1,88 @@
+#include "Benchmark.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <random>
+
+namespace {
+	std::atomic<unsigned long long> globalAllocationCount(0);
+	std::atomic<unsigned long long> globalAllocatedBytes(0);
+}
+
+// Replacing the global allocation functions allows to count every allocation made by the library
+void* operator new(std::size_t size)
+{
+	globalAllocationCount++;
+	globalAllocatedBytes += size;
+	void* pointer = std::malloc(size ? size : 1);
+	if (pointer == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return pointer;
+}
+
+void operator delete(void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+namespace TetrisAI {
+
+	unsigned long long allocationCount()
+	{
+		return globalAllocationCount;
+	}
+
+	unsigned long long allocatedBytes()
+	{
+		return globalAllocatedBytes;
+	}
+
+	std::vector<MoveMeasure> measureMoves(const BenchmarkSettings& settings, AIStrategy& strategy)
+	{
+		std::mt19937 generator(settings.seed);
+		std::vector<Polyomino> polyominos(Polyomino::getPolyominosList(settings.polyominoSquares));
+		std::uniform_int_distribution<int> distribution(0, polyominos.size() - 1);
+		GameState gameState(settings.gridWidth, settings.gridHeight, settings.gridLayout);
+
+		// Draw in advance a certain amount of polyominos
+		for (unsigned i = 0; i < settings.stepsAhead; i++)
+		{
+			gameState.addPolyominoToQueue(&(polyominos[distribution(generator)]));
+		}
+
+		std::vector<MoveMeasure> measures;
+		measures.reserve(settings.moves);
+		for (unsigned move = 0; move < settings.moves; move++)
+		{
+			gameState.addPolyominoToQueue(&(polyominos[distribution(generator)]));
+
+			MoveMeasure measure;
+			unsigned long long allocationsBefore(allocationCount()), bytesBefore(allocatedBytes());
+			auto start(std::chrono::steady_clock::now());
+			Transformation chosenMove(strategy.decideMove(gameState, polyominos));
+			measure.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			measure.allocations = allocationCount() - allocationsBefore;
+			measure.allocatedBytes = allocatedBytes() - bytesBefore;
+			measure.linesCleared = 0;
+
+			if (chosenMove.translation == -1 || !gameState.play(chosenMove))
+			{
+				measures.push_back(measure);
+				break;
+			}
+			measure.linesCleared = gameState.getMoveResult().linesCleared;
+			measures.push_back(measure);
+		}
+
+		return measures;
+	}
+
+}
@@ -0,0 +1,106 @@
+#ifndef TETRISAI_BENCHMARK_H
+#define TETRISAI_BENCHMARK_H
+
+#include <atomic>
+#include <vector>
+#include "AIStrategy.h"
+#include "DellacherieHeuristic.h"
+
+namespace TetrisAI {
+
+	struct BenchmarkSettings {
+		short gridWidth;
+		short gridHeight;
+		/// <summary>Number of squares composing the polyominos</summary>
+		unsigned int polyominoSquares;
+		/// <summary>Number of polyominos known in advance (after the one currently being played)</summary>
+		unsigned int stepsAhead;
+		/// <summary>Decision tree depths that should be benchmarked one after the other</summary>
+		std::vector<unsigned int> depths;
+		/// <summary>Number of moves played for each measure</summary>
+		unsigned int moves;
+		/// <summary>Seed used to draw polyominos so that every run plays the exact same sequence</summary>
+		unsigned int seed;
+		bool useMultithreading;
+		Grid::Layout gridLayout;
+		/// <summary>The transposition table holds 2^transpositionTableSizeLog2 entries</summary>
+		unsigned int transpositionTableSizeLog2;
+	};
+
+	/// <summary>Dellacherie heuristic counting the game states it evaluates (i.e. the leaves built by the decision tree)</summary>
+	class CountingHeuristic : public DellacherieHeuristic {
+	public:
+		CountingHeuristic() : evaluations(0) {}
+
+		virtual float evaluate(const GameState& gs)
+		{
+			evaluations++;
+			return DellacherieHeuristic::evaluate(gs);
+		}
+
+		std::atomic<unsigned long long> evaluations;
+	};
+
+	/// <summary>Measures collected around a single call to AIStrategy::decideMove</summary>
+	struct MoveMeasure {
+		double seconds;
+		/// <summary>Number of lines cleared by the move decided</summary>
+		int linesCleared;
+		unsigned long long allocations;
+		unsigned long long allocatedBytes;
+	};
+
+	/// <summary>Returns the number of calls made to the global operator new since the start of the program</summary>
+	unsigned long long allocationCount();
+
+	/// <summary>Returns the number of bytes requested to the global operator new since the start of the program</summary>
+	unsigned long long allocatedBytes();
+
+	/// <summary>Plays a sequence of moves with the given strategy and measures every decision</summary>
+	/// <param name="settings">Settings describing the game that should be played</param>
+	/// <param name="strategy">Strategy deciding the moves (it should not have played any move yet)</param>
+	/// <returns>One measure per decision taken (the sequence may be shorter than expected if a game over occurs)</returns>
+	std::vector<MoveMeasure> measureMoves(const BenchmarkSettings& settings, AIStrategy& strategy);
+
+	/// <summary>Reports the number of heap allocations performed per decision for each of the configured depths</summary>
+	int allocationBenchmark(const BenchmarkSettings& settings);
+
+	/// <summary>Reports the size of the grid structures and the nodes evaluated per second for the row type the library was built with</summary>
+	int rowTypeBenchmark(const BenchmarkSettings& settings);
+
+	/// <summary>Compares, for each of the configured depths, the decisions taken with and without a transposition table</summary>
+	int transpositionBenchmark(const BenchmarkSettings& settings);
+
+	/// <summary>Compares, for each of the configured depths, the evaluated nodes per second of a tree of nodes and of a flat tree</summary>
+	int flatTreeBenchmark(const BenchmarkSettings& settings);
+
+	/// <summary>Reports, for each of the configured depths, the core utilization and the tasks of the thread pool of a multithreaded strategy</summary>
+	int threadPoolBenchmark(const BenchmarkSettings& settings);
+
+	/// <summary>Compares, for each of the configured depths, the nodes searched by an expectimax search with and without pruning</summary>
+	int pruningBenchmark(const BenchmarkSettings& settings);
+
+	/// <summary>Reports, for several time budgets per move and each of the configured depths (as a maximum), the decision times and the depths reached by an iteratively deepened search</summary>
+	int timeBudgetBenchmark(const BenchmarkSettings& settings);
+
+	/// <summary>Compares, for each of the configured depths, the lines cleared and the evaluated nodes per second of a decision tree and of beam searches of several widths</summary>
+	int beamSearchBenchmark(const BenchmarkSettings& settings);
+
+	/// <summary>Reports, for each of the configured rollout depths, the lines cleared and the rollouts per second of Monte Carlo searches grown by one thread and by every core</summary>
+	int monteCarloBenchmark(const BenchmarkSettings& settings);
+
+	/// <summary>Reports, for each of the configured depths, the memory held, the subtrees collapsed and the decisions of a decision tree with several memory budgets</summary>
+	int memoryBudgetBenchmark(const BenchmarkSettings& settings);
+
+	/// <summary>Compares, for each of the configured depths, the evaluated nodes, the lines cleared and the decisions of a decision tree expanding every unknown polyomino and of decision trees expanding a sample of them</summary>
+	int chanceSamplingBenchmark(const BenchmarkSettings& settings);
+
+	/// <summary>Compares, for each of the configured depths, the decision times of a decision tree without pondering and with pondering during several gaps between the moves</summary>
+	int ponderingBenchmark(const BenchmarkSettings& settings);
+
+	/// <summary>Compares, for each of the configured depths, the moves generated and expanded, the lines cleared and the decisions of a decision tree expanding every move and of decision trees expanding the best moves only</summary>
+	int lazyExpansionBenchmark(const BenchmarkSettings& settings);
+
+}
+
+#endif
@@ -0,0 +1,80 @@
+#include "Benchmark.h"
+#include <iostream>
+#include <string>
+#include "HeuristicStrategy.h"
+#include "ChanceSampling.h"
+
+namespace TetrisAI {
+
+	namespace {
+		/// <summary>Forwards the decisions to another strategy and keeps the moves decided</summary>
+		class MoveRecorder : public AIStrategy {
+		public:
+			MoveRecorder(AIStrategy& strategy) : strategy(strategy) {}
+
+			virtual Transformation decideMove(const GameState& gs, std::vector<Polyomino>& possiblePolyominos)
+			{
+				Transformation move(strategy.decideMove(gs, possiblePolyominos));
+				moves.push_back(move);
+				return move;
+			}
+
+			std::vector<Transformation> moves;
+
+		private:
+			AIStrategy& strategy;
+		};
+
+		struct SamplingSetting {
+			/// <summary>Number of polyominos expanded by each node whose next polyomino is unknown (0 to expand all of them)</summary>
+			unsigned samples;
+			ChanceSampling::Method method;
+		};
+	}
+
+	int chanceSamplingBenchmark(const BenchmarkSettings& settings)
+	{
+		std::cout << "depth\tsampling\tmoves\tevaluated nodes/move\tseconds/move\tlines\tsame moves" << std::endl;
+		for (auto depth : settings.depths)
+		{
+			// The full tree comes first: the decisions of the sampled ones are compared to its decisions
+			std::vector<Transformation> fullTreeMoves;
+			for (const SamplingSetting& setting : { SamplingSetting{ 0, ChanceSampling::Method::Random }, SamplingSetting{ 3, ChanceSampling::Method::Random },
+				SamplingSetting{ 3, ChanceSampling::Method::Stratified }, SamplingSetting{ 6, ChanceSampling::Method::Stratified } })
+			{
+				std::unique_ptr<ChanceSampling> sampling(setting.samples > 0 ? std::make_unique<ChanceSampling>(setting.samples, setting.method, settings.seed) : nullptr);
+				CountingHeuristic heuristic;
+				HeuristicStrategy strategy(heuristic, depth, settings.useMultithreading, nullptr, 0, sampling.get());
+				MoveRecorder recorder(strategy);
+				std::vector<MoveMeasure> measures(measureMoves(settings, recorder));
+				if (measures.empty())
+				{
+					continue;
+				}
+				if (!sampling)
+				{
+					fullTreeMoves = recorder.moves;
+				}
+
+				double seconds(0);
+				int lines(0);
+				unsigned sameMoves(0);
+				for (unsigned i = 0; i < measures.size(); i++)
+				{
+					seconds += measures[i].seconds;
+					lines += measures[i].linesCleared;
+					if (i < fullTreeMoves.size() && recorder.moves[i].translation == fullTreeMoves[i].translation && recorder.moves[i].rotation == fullTreeMoves[i].rotation)
+					{
+						sameMoves++;
+					}
+				}
+
+				std::string name(!sampling ? "none" : std::to_string(setting.samples) + (setting.method == ChanceSampling::Method::Random ? " random" : " stratified"));
+				std::cout << depth << "\t" << name << "\t" << measures.size() << "\t" << heuristic.evaluations / measures.size() << "\t" << seconds / measures.size() << "\t"
+					<< lines << "\t" << sameMoves << std::endl;
+			}
+		}
+		return 0;
+	}
+
+}
@@ -0,0 +1,33 @@
+#include "Benchmark.h"
+#include <iostream>
+#include "HeuristicStrategy.h"
+#include "FlatTreeStrategy.h"
+
+namespace TetrisAI {
+
+	int flatTreeBenchmark(const BenchmarkSettings& settings)
+	{
+		std::cout << "depth\ttree\tmoves\tevaluated nodes\tseconds\tnodes/second" << std::endl;
+		for (auto depth : settings.depths)
+		{
+			for (bool useFlatTree : { false, true })
+			{
+				CountingHeuristic heuristic;
+				HeuristicStrategy nodeTree(heuristic, depth, settings.useMultithreading);
+				FlatTreeStrategy flatTree(heuristic, depth);
+				std::vector<MoveMeasure> measures(measureMoves(settings, useFlatTree ? static_cast<AIStrategy&>(flatTree) : nodeTree));
+
+				double seconds(0);
+				for (auto& measure : measures)
+				{
+					seconds += measure.seconds;
+				}
+
+				std::cout << depth << "\t" << (useFlatTree ? "flat" : "nodes") << "\t" << measures.size() << "\t" << heuristic.evaluations << "\t"
+					<< seconds << "\t" << (seconds > 0 ? heuristic.evaluations / seconds : 0) << std::endl;
+			}
+		}
+		return 0;
+	}
+
+}
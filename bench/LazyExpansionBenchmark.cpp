@@ -0,0 +1,82 @@
+#include "Benchmark.h"
+#include <iostream>
+#include <limits>
+#include <string>
+#include "HeuristicStrategy.h"
+#include "LazyExpansion.h"
+
+namespace TetrisAI {
+
+	namespace {
+		/// <summary>Forwards the decisions to another strategy and keeps the moves decided</summary>
+		class MoveRecorder : public AIStrategy {
+		public:
+			MoveRecorder(AIStrategy& strategy) : strategy(strategy) {}
+
+			virtual Transformation decideMove(const GameState& gs, std::vector<Polyomino>& possiblePolyominos)
+			{
+				Transformation move(strategy.decideMove(gs, possiblePolyominos));
+				moves.push_back(move);
+				return move;
+			}
+
+			std::vector<Transformation> moves;
+
+		private:
+			AIStrategy& strategy;
+		};
+
+		struct LazySetting {
+			/// <summary>Largest number of moves expanded by a node (0 to expand every move)</summary>
+			unsigned width;
+			float margin;
+		};
+	}
+
+	int lazyExpansionBenchmark(const BenchmarkSettings& settings)
+	{
+		const float noMargin(std::numeric_limits<float>::infinity());
+		std::cout << "depth\twidth\tmargin\tmoves\tgenerated moves/move\texpanded moves/move\tevaluated nodes/move\tseconds/move\tlines\tsame moves" << std::endl;
+		for (auto depth : settings.depths)
+		{
+			// The full tree comes first: the decisions of the lazy ones are compared to its decisions
+			std::vector<Transformation> fullTreeMoves;
+			for (const LazySetting& setting : { LazySetting{ 0, noMargin }, LazySetting{ 8, noMargin }, LazySetting{ 4, noMargin }, LazySetting{ 8, 20 }, LazySetting{ 2, noMargin } })
+			{
+				std::unique_ptr<LazyExpansion> lazyExpansion(setting.width > 0 ? std::make_unique<LazyExpansion>(setting.width, setting.margin) : nullptr);
+				CountingHeuristic heuristic;
+				HeuristicStrategy strategy(heuristic, depth, settings.useMultithreading, nullptr, 0, nullptr, false, lazyExpansion.get());
+				MoveRecorder recorder(strategy);
+				std::vector<MoveMeasure> measures(measureMoves(settings, recorder));
+				if (measures.empty())
+				{
+					continue;
+				}
+				if (!lazyExpansion)
+				{
+					fullTreeMoves = recorder.moves;
+				}
+
+				double seconds(0);
+				int lines(0);
+				unsigned sameMoves(0);
+				for (unsigned i = 0; i < measures.size(); i++)
+				{
+					seconds += measures[i].seconds;
+					lines += measures[i].linesCleared;
+					if (i < fullTreeMoves.size() && recorder.moves[i].translation == fullTreeMoves[i].translation && recorder.moves[i].rotation == fullTreeMoves[i].rotation)
+					{
+						sameMoves++;
+					}
+				}
+
+				unsigned long long generated(lazyExpansion ? lazyExpansion->getGeneratedMoves() : 0), expanded(lazyExpansion ? lazyExpansion->getExpandedMoves() : 0);
+				std::cout << depth << "\t" << (setting.width > 0 ? std::to_string(setting.width) : "all") << "\t" << (setting.margin < noMargin ? std::to_string(setting.margin) : "none") << "\t"
+					<< measures.size() << "\t" << generated / measures.size() << "\t" << expanded / measures.size() << "\t" << heuristic.evaluations / measures.size() << "\t"
+					<< seconds / measures.size() << "\t" << lines << "\t" << sameMoves << std::endl;
+			}
+		}
+		return 0;
+	}
+
+}
@@ -0,0 +1,76 @@
+#include "Benchmark.h"
+#include <iostream>
+#include <string>
+#include "HeuristicStrategy.h"
+
+namespace TetrisAI {
+
+	namespace {
+		/// <summary>Forwards the decisions to a decision tree and keeps the moves decided and the memory held for each of them</summary>
+		class MemoryRecorder : public AIStrategy {
+		public:
+			MemoryRecorder(HeuristicStrategy& strategy) : strategy(strategy) {}
+
+			virtual Transformation decideMove(const GameState& gs, std::vector<Polyomino>& possiblePolyominos)
+			{
+				Transformation move(strategy.decideMove(gs, possiblePolyominos));
+				moves.push_back(move);
+				memory.push_back(strategy.getLastMoveMemory());
+				return move;
+			}
+
+			std::vector<Transformation> moves;
+			std::vector<HeuristicStrategy::MemoryStatistics> memory;
+
+		private:
+			HeuristicStrategy& strategy;
+		};
+	}
+
+	int memoryBudgetBenchmark(const BenchmarkSettings& settings)
+	{
+		const double megabyte(1024 * 1024);
+		std::cout << "depth\tbudget (MB)\tmoves\tpeak (MB)\tkept after move (MB)\tcollapses/move\tseconds/move\tsame moves" << std::endl;
+		for (auto depth : settings.depths)
+		{
+			// The unbounded tree comes first: the decisions of the bounded ones are compared to its decisions
+			std::vector<Transformation> unboundedMoves;
+			for (std::size_t budget : { 0, 256, 64, 16 })
+			{
+				DellacherieHeuristic heuristic;
+				HeuristicStrategy strategy(heuristic, depth, settings.useMultithreading, nullptr, budget * 1024 * 1024);
+				MemoryRecorder recorder(strategy);
+				std::vector<MoveMeasure> measures(measureMoves(settings, recorder));
+				if (measures.empty())
+				{
+					continue;
+				}
+				if (budget == 0)
+				{
+					unboundedMoves = recorder.moves;
+				}
+
+				double seconds(0);
+				std::size_t peak(0), kept(0);
+				unsigned long long collapses(0);
+				unsigned sameMoves(0);
+				for (unsigned i = 0; i < measures.size(); i++)
+				{
+					seconds += measures[i].seconds;
+					peak = recorder.memory[i].peakBytes > peak ? recorder.memory[i].peakBytes : peak;
+					kept = recorder.memory[i].bytesInUse > kept ? recorder.memory[i].bytesInUse : kept;
+					collapses += recorder.memory[i].collapses;
+					if (i < unboundedMoves.size() && recorder.moves[i].translation == unboundedMoves[i].translation && recorder.moves[i].rotation == unboundedMoves[i].rotation)
+					{
+						sameMoves++;
+					}
+				}
+
+				std::cout << depth << "\t" << (budget > 0 ? std::to_string(budget) : "none") << "\t" << measures.size() << "\t" << peak / megabyte << "\t" << kept / megabyte << "\t"
+					<< collapses / measures.size() << "\t" << seconds / measures.size() << "\t" << sameMoves << std::endl;
+			}
+		}
+		return 0;
+	}
+
+}
@@ -0,0 +1,46 @@
+#include "Benchmark.h"
+#include <iostream>
+#include <thread>
+#include "HeuristicStrategy.h"
+#include "MonteCarloStrategy.h"
+
+namespace TetrisAI {
+
+	int monteCarloBenchmark(const BenchmarkSettings& settings)
+	{
+		// Trees are grown by a single thread and by every core (root parallelization), each decision doing the same number of rollouts
+		unsigned int cores(std::thread::hardware_concurrency());
+		std::vector<unsigned int> threadCounts({ 1 });
+		if (cores > 1)
+		{
+			threadCounts.push_back(cores);
+		}
+
+		std::cout << "rollout depth\trollouts/move\tthreads\tmoves\tlines cleared\tevaluated nodes\tseconds\trollouts/second" << std::endl;
+		for (auto depth : settings.depths)
+		{
+			for (unsigned int rollouts : { 256, 1024 })
+			{
+				for (auto threads : threadCounts)
+				{
+					CountingHeuristic heuristic;
+					MonteCarloStrategy strategy(heuristic, rollouts, depth, threads, std::chrono::microseconds::zero(), settings.seed);
+					std::vector<MoveMeasure> measures(measureMoves(settings, strategy));
+
+					double seconds(0);
+					int lines(0);
+					for (auto& measure : measures)
+					{
+						seconds += measure.seconds;
+						lines += measure.linesCleared;
+					}
+					unsigned long long doneRollouts(strategy.getStatistics().rollouts);
+					std::cout << depth << "\t" << rollouts << "\t" << threads << "\t" << measures.size() << "\t" << lines << "\t" << heuristic.evaluations << "\t"
+						<< seconds << "\t" << (seconds > 0 ? doneRollouts / seconds : 0) << std::endl;
+				}
+			}
+		}
+		return 0;
+	}
+
+}
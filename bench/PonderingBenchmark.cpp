@@ -0,0 +1,83 @@
+#include "Benchmark.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "HeuristicStrategy.h"
+
+namespace TetrisAI {
+
+	namespace {
+		/// <summary>Waits for a fixed time before each decision, as if the previous piece was falling, and measures the decision alone</summary>
+		class SteadyRateRecorder : public AIStrategy {
+		public:
+			SteadyRateRecorder(HeuristicStrategy& strategy, std::chrono::milliseconds gap) : strategy(strategy), gap(gap) {}
+
+			virtual Transformation decideMove(const GameState& gs, std::vector<Polyomino>& possiblePolyominos)
+			{
+				std::this_thread::sleep_for(gap);
+				auto start(std::chrono::steady_clock::now());
+				Transformation move(strategy.decideMove(gs, possiblePolyominos));
+				latencies.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+				moves.push_back(move);
+				ponderings.push_back(strategy.getLastPondering());
+				return move;
+			}
+
+			std::vector<double> latencies;
+			std::vector<Transformation> moves;
+			std::vector<HeuristicStrategy::PonderingStatistics> ponderings;
+
+		private:
+			HeuristicStrategy& strategy;
+			std::chrono::milliseconds gap;
+		};
+	}
+
+	int ponderingBenchmark(const BenchmarkSettings& settings)
+	{
+		std::cout << "depth\tpondering\tgap (ms)\tmoves\tseconds/move\tmax seconds\tcompleted ponderings\tpondering seconds/move\tsame moves" << std::endl;
+		for (auto depth : settings.depths)
+		{
+			// The strategy without pondering comes first: the decisions of the other ones are compared to its decisions
+			std::vector<Transformation> referenceMoves;
+			for (unsigned setting = 0; setting < 6; setting++)
+			{
+				// Each gap is measured without pondering as well, waiting between the decisions slowing them down by itself (colder caches)
+				bool usePondering(setting % 2 == 1);
+				int gap(setting < 2 ? 0 : (setting < 4 ? 10 : 100));
+				DellacherieHeuristic heuristic;
+				HeuristicStrategy strategy(heuristic, depth, settings.useMultithreading, nullptr, 0, nullptr, usePondering);
+				SteadyRateRecorder recorder(strategy, std::chrono::milliseconds(gap));
+				if (measureMoves(settings, recorder).empty())
+				{
+					continue;
+				}
+				if (referenceMoves.empty())
+				{
+					referenceMoves = recorder.moves;
+				}
+
+				double seconds(0), maxSeconds(0), ponderingSeconds(0);
+				unsigned completed(0), sameMoves(0);
+				for (unsigned i = 0; i < recorder.moves.size(); i++)
+				{
+					seconds += recorder.latencies[i];
+					maxSeconds = recorder.latencies[i] > maxSeconds ? recorder.latencies[i] : maxSeconds;
+					ponderingSeconds += recorder.ponderings[i].seconds;
+					completed += recorder.ponderings[i].completed ? 1 : 0;
+					if (i < referenceMoves.size() && recorder.moves[i].translation == referenceMoves[i].translation && recorder.moves[i].rotation == referenceMoves[i].rotation)
+					{
+						sameMoves++;
+					}
+				}
+
+				unsigned moves(recorder.moves.size());
+				std::cout << depth << "\t" << (usePondering ? "yes" : "no") << "\t" << gap << "\t" << moves << "\t" << seconds / moves << "\t" << maxSeconds << "\t"
+					<< completed << "\t" << ponderingSeconds / moves << "\t" << sameMoves << std::endl;
+			}
+		}
+		return 0;
+	}
+
+}
@@ -0,0 +1,32 @@
+#include "Benchmark.h"
+#include <iostream>
+#include "ExpectimaxStrategy.h"
+
+namespace TetrisAI {
+
+	int pruningBenchmark(const BenchmarkSettings& settings)
+	{
+		std::cout << "depth\tpruning\tmoves\tsearched nodes\tevaluated nodes\tcutoffs\tpruned subtrees\tseconds" << std::endl;
+		for (auto depth : settings.depths)
+		{
+			for (bool usePruning : { false, true })
+			{
+				DellacherieHeuristic heuristic;
+				ExpectimaxStrategy strategy(heuristic, depth, usePruning);
+				std::vector<MoveMeasure> measures(measureMoves(settings, strategy));
+
+				double seconds(0);
+				for (auto& measure : measures)
+				{
+					seconds += measure.seconds;
+				}
+
+				ExpectimaxStrategy::Statistics statistics(strategy.getStatistics());
+				std::cout << depth << "\t" << (usePruning ? "on" : "off") << "\t" << measures.size() << "\t" << statistics.searchedNodes << "\t"
+					<< statistics.evaluatedNodes << "\t" << statistics.cutoffs << "\t" << statistics.prunedSubtrees << "\t" << seconds << std::endl;
+			}
+		}
+		return 0;
+	}
+
+}
@@ -0,0 +1,36 @@
+#include "Benchmark.h"
+#include <iostream>
+#include "HeuristicStrategy.h"
+#include "Row.h"
+
+namespace TetrisAI {
+
+	int rowTypeBenchmark(const BenchmarkSettings& settings)
+	{
+		std::cout << "row bits: " << rowBits << "\tGrid: " << sizeof(Grid) << " bytes\tGameState: " << sizeof(GameState) << " bytes" << std::endl;
+		std::cout << "depth\tmoves\tevaluated nodes/s\tbytes allocated/move" << std::endl;
+		for (auto depth : settings.depths)
+		{
+			CountingHeuristic heuristic;
+			HeuristicStrategy strategy(heuristic, depth, settings.useMultithreading);
+			std::vector<MoveMeasure> measures(measureMoves(settings, strategy));
+			if (measures.empty())
+			{
+				continue;
+			}
+
+			double seconds(0);
+			unsigned long long bytes(0);
+			for (auto& measure : measures)
+			{
+				seconds += measure.seconds;
+				bytes += measure.allocatedBytes;
+			}
+
+			std::cout << depth << "\t" << measures.size() << "\t" << (seconds > 0 ? heuristic.evaluations / seconds : 0) << "\t"
+				<< bytes / measures.size() << std::endl;
+		}
+		return 0;
+	}
+
+}
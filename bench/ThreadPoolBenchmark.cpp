@@ -0,0 +1,61 @@
+#include "Benchmark.h"
+#include <iostream>
+#include "HeuristicStrategy.h"
+
+namespace TetrisAI {
+
+	namespace {
+		/// <summary>Forwards the decisions to a multithreaded strategy and keeps the statistics of its thread pool for each of them</summary>
+		class PoolStatisticsRecorder : public AIStrategy {
+		public:
+			PoolStatisticsRecorder(HeuristicStrategy& strategy) : strategy(strategy) {}
+
+			virtual Transformation decideMove(const GameState& gs, std::vector<Polyomino>& possiblePolyominos)
+			{
+				Transformation move(strategy.decideMove(gs, possiblePolyominos));
+				statistics.push_back(strategy.getLastMoveStatistics());
+				return move;
+			}
+
+			std::vector<ThreadPool::Statistics> statistics;
+
+		private:
+			HeuristicStrategy& strategy;
+		};
+	}
+
+	int threadPoolBenchmark(const BenchmarkSettings& settings)
+	{
+		std::cout << "depth\tmoves\tseconds/move (next moves)\tutilization (first move)\tutilization (next moves)\ttasks/move\tsteals/move" << std::endl;
+		for (auto depth : settings.depths)
+		{
+			DellacherieHeuristic heuristic;
+			HeuristicStrategy strategy(heuristic, depth, true);
+			PoolStatisticsRecorder recorder(strategy);
+			measureMoves(settings, recorder);
+			if (recorder.statistics.empty())
+			{
+				continue;
+			}
+
+			// The first decision builds the whole tree while the next ones update it: both are reported separately
+			double seconds(0), busySeconds(0);
+			unsigned long long tasks(0), steals(0);
+			for (unsigned i = 1; i < recorder.statistics.size(); i++)
+			{
+				const ThreadPool::Statistics& move(recorder.statistics[i]);
+				seconds += move.seconds;
+				busySeconds += move.seconds * move.utilization;
+				tasks += move.tasks;
+				steals += move.steals;
+			}
+			unsigned nextMoves(recorder.statistics.size() - 1);
+
+			std::cout << depth << "\t" << recorder.statistics.size() << "\t" << (nextMoves ? seconds / nextMoves : 0) << "\t"
+				<< recorder.statistics[0].utilization << "\t" << (seconds > 0 ? busySeconds / seconds : 0) << "\t"
+				<< (nextMoves ? tasks / nextMoves : 0) << "\t" << (nextMoves ? steals / nextMoves : 0) << std::endl;
+		}
+		return 0;
+	}
+
+}
@@ -0,0 +1,58 @@
+#include "Benchmark.h"
+#include <iostream>
+#include "ExpectimaxStrategy.h"
+
+namespace TetrisAI {
+
+	namespace {
+		/// <summary>Forwards the decisions to an expectimax search and keeps the number of moves each of them considered</summary>
+		class DepthRecorder : public AIStrategy {
+		public:
+			DepthRecorder(ExpectimaxStrategy& strategy) : strategy(strategy) {}
+
+			virtual Transformation decideMove(const GameState& gs, std::vector<Polyomino>& possiblePolyominos)
+			{
+				Transformation move(strategy.decideMove(gs, possiblePolyominos));
+				depths.push_back(strategy.getLastDepth());
+				return move;
+			}
+
+			std::vector<unsigned int> depths;
+
+		private:
+			ExpectimaxStrategy& strategy;
+		};
+	}
+
+	int timeBudgetBenchmark(const BenchmarkSettings& settings)
+	{
+		std::cout << "max depth\tbudget (ms)\tmoves\tmean depth\tmean seconds/move\tmax seconds/move\taborted searches" << std::endl;
+		for (auto depth : settings.depths)
+		{
+			for (int budget : { 1, 5, 20 })
+			{
+				DellacherieHeuristic heuristic;
+				ExpectimaxStrategy strategy(heuristic, depth, true, std::chrono::milliseconds(budget));
+				DepthRecorder recorder(strategy);
+				std::vector<MoveMeasure> measures(measureMoves(settings, recorder));
+				if (measures.empty())
+				{
+					continue;
+				}
+
+				double seconds(0), maxSeconds(0), depths(0);
+				for (unsigned i = 0; i < measures.size(); i++)
+				{
+					seconds += measures[i].seconds;
+					maxSeconds = measures[i].seconds > maxSeconds ? measures[i].seconds : maxSeconds;
+					depths += recorder.depths[i];
+				}
+
+				std::cout << depth << "\t" << budget << "\t" << measures.size() << "\t" << depths / measures.size() << "\t" << seconds / measures.size() << "\t"
+					<< maxSeconds << "\t" << strategy.getStatistics().abortedSearches << std::endl;
+			}
+		}
+		return 0;
+	}
+
+}
@@ -0,0 +1,34 @@
+#include "Benchmark.h"
+#include <iostream>
+#include "HeuristicStrategy.h"
+#include "TranspositionTable.h"
+
+namespace TetrisAI {
+
+	int transpositionBenchmark(const BenchmarkSettings& settings)
+	{
+		std::cout << "depth\ttable\tmoves\tevaluated nodes\tseconds\thit rate" << std::endl;
+		TranspositionTable transpositionTable(settings.transpositionTableSizeLog2);
+		for (auto depth : settings.depths)
+		{
+			for (bool useTable : { false, true })
+			{
+				transpositionTable.clear();
+				CountingHeuristic heuristic;
+				HeuristicStrategy strategy(heuristic, depth, settings.useMultithreading, useTable ? &transpositionTable : nullptr);
+				std::vector<MoveMeasure> measures(measureMoves(settings, strategy));
+
+				double seconds(0);
+				for (auto& measure : measures)
+				{
+					seconds += measure.seconds;
+				}
+
+				std::cout << depth << "\t" << (useTable ? "yes" : "no") << "\t" << measures.size() << "\t" << heuristic.evaluations << "\t"
+					<< seconds << "\t" << (useTable ? transpositionTable.getHitRate() : 0) << std::endl;
+			}
+		}
+		return 0;
+	}
+
+}
@@ -0,0 +1,80 @@
+#include <boost/program_options.hpp>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include "Benchmark.h"
+
+using namespace TetrisAI;
+
+int main(int argc, char* argv[])
+{
+	std::map<std::string, std::function<int(const BenchmarkSettings&)>> benchmarks({
+		{ "allocations", allocationBenchmark },
+		{ "rows", rowTypeBenchmark },
+		{ "transposition", transpositionBenchmark },
+		{ "flat", flatTreeBenchmark },
+		{ "threads", threadPoolBenchmark },
+		{ "pruning", pruningBenchmark },
+		{ "budget", timeBudgetBenchmark },
+		{ "beam", beamSearchBenchmark },
+		{ "mcts", monteCarloBenchmark },
+		{ "memory", memoryBudgetBenchmark },
+		{ "sampling", chanceSamplingBenchmark },
+		{ "ponder", ponderingBenchmark },
+		{ "lazy", lazyExpansionBenchmark }
+	});
+
+	BenchmarkSettings settings;
+	std::string benchmarkName;
+	int width(10), height(20);
+	bool useColumnLayout(false);
+
+	namespace po = boost::program_options;
+	po::options_description desc("Allowed options");
+	desc.add_options()
+		("help", "produce help message")
+		("benchmark,b", po::value<std::string>(&benchmarkName)->default_value("allocations"), "name of the benchmark to run [allocations, rows, transposition, flat, threads, pruning, budget, beam, mcts, memory, sampling, ponder, lazy]")
+		("height,h", po::value<int>(&height)->default_value(height), "set height of the grid")
+		("width,w", po::value<int>(&width)->default_value(width), "set width of the grid")
+		("polyomino,p", po::value<unsigned int>(&settings.polyominoSquares)->default_value(4), "set the number of squares composing polyominos")
+		("stepsAhead,s", po::value<unsigned int>(&settings.stepsAhead)->default_value(3), "set the number of polyominos known in advance")
+		("heuristicDepth,d", po::value<std::vector<unsigned int>>(&settings.depths)->multitoken()->default_value({ 3, 4 }, "3 4"), "set the decision tree depths to benchmark")
+		("moves,m", po::value<unsigned int>(&settings.moves)->default_value(5), "set the number of moves played for each measure")
+		("seed", po::value<unsigned int>(&settings.seed)->default_value(42), "set the seed used to draw polyominos")
+		("multithreading", po::bool_switch(&settings.useMultithreading), "enable multithreading for AI computations")
+		("columnLayout", po::bool_switch(&useColumnLayout), "maintain a column-major copy of the grid")
+		("transpositionTableSize", po::value<unsigned int>(&settings.transpositionTableSizeLog2)->default_value(20), "set the base 2 logarithm of the number of entries of the transposition table")
+		;
+
+	po::variables_map vm;
+	try
+	{
+		po::store(po::parse_command_line(argc, argv, desc), vm);
+		po::notify(vm);
+	}
+	catch (po::error& e)
+	{
+		std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+		std::cerr << desc << std::endl;
+		return 1;
+	}
+
+	if (vm.count("help"))
+	{
+		std::cout << desc << "\n";
+		return 1;
+	}
+
+	auto benchmark(benchmarks.find(benchmarkName));
+	if (benchmark == benchmarks.end())
+	{
+		std::cerr << "Unknown benchmark: " << benchmarkName << std::endl;
+		return 1;
+	}
+
+	settings.gridWidth = width;
+	settings.gridHeight = height;
+	settings.gridLayout = useColumnLayout ? Grid::Layout::RowAndColumnMajor : Grid::Layout::RowMajor;
+	return benchmark->second(settings);
+}
@@ -9,6 +9,9 @@ namespace TetrisAI {
 
 	class AIStrategy {
 	public:
+		// Strategies may own threads that must be stopped whatever pointer destroys them
+		virtual ~AIStrategy() {};
+
 		/// <summary>Decides which move is the best and returns the corresponding transformation</summary>
 		/// <param name="gs">GameState in which the polyomino must be played</param>
 		/// <returns>The polyomino's transformation that corresponds to the best move according to the AI</returns>
@@ -0,0 +1,191 @@
+#include "BeamSearchStrategy.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace TetrisAI {
+
+	namespace {
+		const float notReached(-std::numeric_limits<float>::infinity());
+	}
+
+	BeamSearchStrategy::BeamSearchStrategy(Heuristic& heuristic, unsigned int depth, unsigned int width, unsigned int samples, unsigned int seed) :
+		heuristic(heuristic), depth(depth), width(width), samples(samples), generator(seed), evaluatedNodes(0), plies(depth)
+	{
+		if (depth < 1 || depth > maxDepth)
+		{
+			throw std::invalid_argument("The depth of a beam search must be between 1 and 32.");
+		}
+		if (width == 0)
+		{
+			throw std::invalid_argument("A beam search must keep at least one game state.");
+		}
+	}
+
+	Transformation BeamSearchStrategy::decideMove(const GameState& gs, std::vector<Polyomino>& possiblePolyominos)
+	{
+		const Polyomino* comingPolyomino(gs.polyominoQueueHead());
+		if (comingPolyomino == nullptr)
+		{
+			throw std::invalid_argument("Given game state does not have any pending polyomino");
+		}
+		std::vector<Placement> placements(gs.getGrid().computePlacements(*comingPolyomino));
+
+		// Moves are compared by the sum of their evaluations over the samples
+		std::vector<double> totals(placements.size(), 0);
+		std::vector<bool> isReached(placements.size(), false);
+		std::vector<float> moveEvaluations;
+		unsigned int sampleCount(samples > 0 ? samples : std::max<std::size_t>(possiblePolyominos.size(), 1));
+		for (unsigned int sample = 0; sample < sampleCount; sample++)
+		{
+			searchSample(gs, placements, possiblePolyominos, sample, moveEvaluations);
+
+			// A move none of whose states were kept is given the lowest evaluation of the sample
+			float lowest(std::numeric_limits<float>::infinity());
+			for (unsigned m = 0; m < placements.size(); m++)
+			{
+				if (moveEvaluations[m] != notReached)
+				{
+					lowest = std::min(lowest, moveEvaluations[m]);
+					isReached[m] = true;
+				}
+			}
+			for (unsigned m = 0; m < placements.size(); m++)
+			{
+				totals[m] += moveEvaluations[m] != notReached ? moveEvaluations[m] : lowest;
+			}
+		}
+
+		int best(-1);
+		for (unsigned m = 0; m < placements.size(); m++)
+		{
+			if (isReached[m] && (best < 0 || totals[m] > totals[best]))
+			{
+				best = m;
+			}
+		}
+
+		if (best < 0)
+		{
+			return Transformation(-1, -1);
+		}
+		GameState bestState(gs);
+		bestState.play(placements[best]);
+		if (bestState.isGameOver())
+		{
+			return Transformation(-1, -1);
+		}
+		return placements[best].transformation;
+	}
+
+	unsigned long long BeamSearchStrategy::getEvaluatedNodes() const
+	{
+		return evaluatedNodes;
+	}
+
+	void BeamSearchStrategy::searchSample(const GameState& gs, const std::vector<Placement>& placements, std::vector<Polyomino>& possiblePolyominos, unsigned int sample, std::vector<float>& moveEvaluations)
+	{
+		// Every move of the coming polyomino is kept so that each of them is compared
+		std::vector<Candidate>& moves(plies[0]);
+		moves.clear();
+		for (unsigned m = 0; m < placements.size(); m++)
+		{
+			moves.push_back(Candidate{ gs, 0, 0, m });
+			moves.back().state.play(placements[m]);
+			moves.back().evaluation = evaluateBranch(0, 0, moves.back().state);
+		}
+
+		const Polyomino* firstUnknownPolyomino(possiblePolyominos.empty() ? nullptr : &possiblePolyominos[sample % possiblePolyominos.size()]);
+		unsigned int lastPly(0);
+		while (lastPly + 1 < depth && expandPly(lastPly + 1, possiblePolyominos, firstUnknownPolyomino))
+		{
+			lastPly++;
+		}
+
+		moveEvaluations.assign(placements.size(), notReached);
+		for (auto& candidate : plies[lastPly])
+		{
+			moveEvaluations[candidate.rootMove] = std::max(moveEvaluations[candidate.rootMove], candidate.evaluation);
+		}
+	}
+
+	float BeamSearchStrategy::evaluateBranch(unsigned int ply, unsigned int parent, const GameState& gs)
+	{
+		// As along a branch of a decision tree, each state of the path evaluates the branch below it
+		float evaluation(heuristic.evaluate(gs));
+		evaluatedNodes++;
+		while (ply-- > 0)
+		{
+			const Candidate& candidate(plies[ply][parent]);
+			evaluation = heuristic.evaluateBranch(candidate.state, evaluation);
+			parent = candidate.parent;
+		}
+		return evaluation;
+	}
+
+	bool BeamSearchStrategy::expandPly(unsigned int ply, std::vector<Polyomino>& possiblePolyominos, const Polyomino*& firstUnknownPolyomino)
+	{
+		const std::vector<Candidate>& parents(plies[ply - 1]);
+		std::vector<Candidate>& children(plies[ply]);
+		children.clear();
+
+		// Every state of a ply played the same polyominos: either they all know the next one, or the same one is chosen for all of them
+		const Polyomino* unknownPolyomino(nullptr);
+		for (unsigned int i = 0; i < parents.size(); i++)
+		{
+			if (parents[i].state.isGameOver())
+			{
+				continue;
+			}
+
+			GameState state(parents[i].state);
+			if (state.polyominoQueueHead() == nullptr)
+			{
+				if (possiblePolyominos.empty())
+				{
+					return false;
+				}
+				if (unknownPolyomino == nullptr && firstUnknownPolyomino != nullptr)
+				{
+					unknownPolyomino = firstUnknownPolyomino;
+					firstUnknownPolyomino = nullptr;
+				}
+				else if (unknownPolyomino == nullptr)
+				{
+					unknownPolyomino = &possiblePolyominos[std::uniform_int_distribution<std::size_t>(0, possiblePolyominos.size() - 1)(generator)];
+				}
+				state.addPolyominoToQueue(unknownPolyomino);
+			}
+
+			for (auto& placement : state.getGrid().computePlacements(*state.polyominoQueueHead()))
+			{
+				children.push_back(Candidate{ state, 0, i, parents[i].rootMove });
+				children.back().state.play(placement);
+				children.back().evaluation = evaluateBranch(ply, i, children.back().state);
+			}
+		}
+
+		if (children.size() > width)
+		{
+			// The best states are kept, the first generated one winning ties so that decisions do not depend on the sorting algorithm
+			std::vector<unsigned int> order(children.size());
+			for (unsigned int i = 0; i < order.size(); i++)
+			{
+				order[i] = i;
+			}
+			std::partial_sort(order.begin(), order.begin() + width, order.end(), [&children](unsigned int a, unsigned int b) {
+				return children[a].evaluation > children[b].evaluation || (children[a].evaluation == children[b].evaluation && a < b);
+			});
+
+			std::vector<Candidate> kept;
+			kept.reserve(width);
+			for (unsigned int i = 0; i < width; i++)
+			{
+				kept.push_back(std::move(children[order[i]]));
+			}
+			children.swap(kept);
+		}
+		return !children.empty();
+	}
+
+}
@@ -0,0 +1,82 @@
+#ifndef TETRISAI_BEAMSEARCHSTRATEGY_H
+#define TETRISAI_BEAMSEARCHSTRATEGY_H
+
+#include <random>
+#include <vector>
+#include "AIStrategy.h"
+#include "Heuristic.h"
+
+namespace TetrisAI {
+
+	/// <summary>
+	/// Strategy looking further ahead than a decision tree by only keeping, after each move considered, the game states best evaluated by the heuristic.
+	///
+	/// Every move of the coming polyomino is considered, then each following ply expands the states kept by the previous one with every move of
+	/// the next polyomino and keeps the width best of them. The cost of a decision thus grows linearly with the depth instead of exponentially.
+	///
+	/// Polyominos that are not known yet are chosen once per ply, every state of the ply playing the same one, and the search is repeated for
+	/// several sequences of polyominos (samples) whose outcomes are averaged. The first unknown polyomino goes through the possible polyominos
+	/// from one sample to the next, so that it takes each of them in turn as a decision tree would, while the next ones are drawn from a seeded generator.
+	/// </summary>
+	class BeamSearchStrategy : public AIStrategy {
+
+	public:
+		/// <summary>Largest number of moves considered in advance (the polyominos of a state are queued one ply at a time)</summary>
+		const static int maxDepth = 32;
+
+		/// <param name="heuristic">Heuristic that should be used to rank the game states</param>
+		/// <param name="depth">Number of moves to be considered in advance</param>
+		/// <param name="width">Number of game states kept after each move (every move of the coming polyomino is kept)</param>
+		/// <param name="samples">Number of sequences of polyominos searched when some are not known yet (0 for one per possible polyomino)</param>
+		/// <param name="seed">Seed of the generator drawing the polyominos that are not known yet</param>
+		/// <exception cred="std::invalid_argument">Thrown if depth is not between 1 and maxDepth or if width is 0</exception>
+		BeamSearchStrategy(Heuristic& heuristic, unsigned int depth, unsigned int width, unsigned int samples = 0, unsigned int seed = 0);
+
+		/// <summary>Evaluate the possible outcomes from the given game state and outputs the best moves based on an heuristic</summary>
+		/// <param name="gs">Game state which should have at least one pending polyomino to be played</param>
+		/// <param name="possiblePolyominos">List of potential polyominos to draw the polyominos that are not known yet from</param>
+		virtual Transformation decideMove(const GameState& gs, std::vector<Polyomino>& possiblePolyominos);
+
+		/// <summary>Returns the number of game states evaluated by the heuristic since the strategy was built</summary>
+		unsigned long long getEvaluatedNodes() const;
+
+	private:
+		/// <summary>Game state kept by a ply</summary>
+		struct Candidate {
+			GameState state;
+			/// <summary>Evaluation of the branch from the coming polyomino down to the state, by which the candidates are ranked</summary>
+			float evaluation;
+			/// <summary>Index of the candidate of the previous ply it was reached from</summary>
+			unsigned int parent;
+			/// <summary>Index of the move of the coming polyomino it was reached from</summary>
+			unsigned int rootMove;
+		};
+
+		Heuristic& heuristic;
+		unsigned int depth;
+		unsigned int width;
+		unsigned int samples;
+		std::mt19937 generator;
+		unsigned long long evaluatedNodes;
+		/// <summary>Candidates kept by each ply of the last search (the arrays are kept from one search to another), the first ply holding every move of the coming polyomino</summary>
+		std::vector<std::vector<Candidate>> plies;
+
+		/// <summary>Searches a sequence of polyominos drawn for the unknown ones and evaluates each move of the coming polyomino</summary>
+		/// <param name="placements">Moves of the coming polyomino</param>
+		/// <param name="sample">Index of the sample, choosing the first polyomino that is not known yet</param>
+		/// <param name="moveEvaluations">Evaluation of the best branch of the last ply reached from each move (-infinity if none was kept)</param>
+		void searchSample(const GameState& gs, const std::vector<Placement>& placements, std::vector<Polyomino>& possiblePolyominos, unsigned int sample, std::vector<float>& moveEvaluations);
+
+		/// <summary>Expands the candidates of a ply with every move of the next polyomino and keeps the best ones as the following ply</summary>
+		/// <returns>False if none of the candidates could be expanded (they are all game overs)</returns>
+		/// <param name="firstUnknownPolyomino">Polyomino played if the next one is not known yet and is the first unknown one (the next ones are drawn)</param>
+		bool expandPly(unsigned int ply, std::vector<Polyomino>& possiblePolyominos, const Polyomino*& firstUnknownPolyomino);
+
+		/// <summary>Evaluates a state of the given ply, then the branch leading to it through Heuristic::evaluateBranch (so that lines cleared on the way count)</summary>
+		/// <param name="parent">Index of the candidate of the previous ply the state was reached from</param>
+		float evaluateBranch(unsigned int ply, unsigned int parent, const GameState& gs);
+	};
+
+}
+
+#endif
@@ -0,0 +1,328 @@
+#include "BitKernels.h"
+#include <type_traits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+	#define TETRISAI_POPCNT_DISPATCH
+	#define TETRISAI_TARGET_POPCNT __attribute__((target("popcnt")))
+	#define TETRISAI_TARGET_BMI2 __attribute__((target("popcnt,bmi2")))
+	#include <immintrin.h>
+	#define TETRISAI_FORCE_INLINE inline __attribute__((always_inline))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	#include <intrin.h>
+	#define TETRISAI_POPCNT_DISPATCH
+	#define TETRISAI_TARGET_POPCNT
+	#define TETRISAI_TARGET_BMI2
+	#define TETRISAI_FORCE_INLINE __forceinline
+#elif defined(_MSC_VER)
+	#define TETRISAI_FORCE_INLINE __forceinline
+#else
+	#define TETRISAI_FORCE_INLINE inline __attribute__((always_inline))
+#endif
+
+namespace TetrisAI {
+
+	namespace {
+
+		/// <summary>Word holding a row in the kernels: computations are performed on at least 32 bits so that narrow rows are not promoted to signed integers</summary>
+		typedef std::conditional<(rowBits > 32), std::uint64_t, std::uint32_t>::type RowWord;
+
+		/// <summary>Population count that compiles to plain arithmetic on any CPU</summary>
+		struct PortablePopcount {
+			static TETRISAI_FORCE_INLINE int count(std::uint32_t value)
+			{
+#if defined(__GNUC__) && !defined(TETRISAI_POPCNT_DISPATCH)
+				// Outside of x86, the compiler picks the best instruction sequence available for the target
+				return __builtin_popcount(value);
+#else
+				// Parallel sum of bits as presented here: http://graphics.stanford.edu/~seander/bithacks.html#CountBitsSetParallel
+				value = value - ((value >> 1) & 0x55555555);
+				value = (value & 0x33333333) + ((value >> 2) & 0x33333333);
+				return (((value + (value >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+#endif
+			}
+
+			static TETRISAI_FORCE_INLINE int count(std::uint64_t value)
+			{
+#if defined(__GNUC__) && !defined(TETRISAI_POPCNT_DISPATCH)
+				return __builtin_popcountll(value);
+#else
+				value = value - ((value >> 1) & 0x5555555555555555ull);
+				value = (value & 0x3333333333333333ull) + ((value >> 2) & 0x3333333333333333ull);
+				return (int)((((value + (value >> 4)) & 0x0F0F0F0F0F0F0F0Full) * 0x0101010101010101ull) >> 56);
+#endif
+			}
+		};
+
+#ifdef TETRISAI_POPCNT_DISPATCH
+		/// <summary>Population count relying on the POPCNT instruction (only usable once its support has been checked)</summary>
+		/// <remarks>It is meant to be inlined in functions compiled for the POPCNT instruction set, where the builtin expands to the instruction</remarks>
+		struct HardwarePopcount {
+			static TETRISAI_FORCE_INLINE int count(std::uint32_t value)
+			{
+#ifdef _MSC_VER
+				return __popcnt(value);
+#else
+				return __builtin_popcount(value);
+#endif
+			}
+
+			static TETRISAI_FORCE_INLINE int count(std::uint64_t value)
+			{
+#if defined(_MSC_VER) && defined(_M_X64)
+				return (int)__popcnt64(value);
+#elif defined(_MSC_VER)
+				return __popcnt((std::uint32_t)value) + __popcnt((std::uint32_t)(value >> 32));
+#else
+				return __builtin_popcountll(value);
+#endif
+			}
+		};
+#endif
+
+		TETRISAI_FORCE_INLINE RowWord completeLine(int width)
+		{
+			return fullRow(width);
+		}
+
+		template<class Popcount>
+		TETRISAI_FORCE_INLINE int blocksCountKernel(const Row* rows, int rowCount)
+		{
+			int output(0);
+			for (int row = 0; row < rowCount; row++)
+			{
+				output += Popcount::count(RowWord(rows[row]));
+			}
+			return output;
+		}
+
+		template<class Popcount>
+		TETRISAI_FORCE_INLINE int rowTransitionsKernel(const Row* rows, int rowCount, int width)
+		{
+			int output(0);
+			RowWord innerMask(completeLine(width) >> 1);
+			for (int row = 0; row < rowCount; row++)
+			{
+				RowWord value(rows[row]);
+				// Bit i of row ^ (row >> 1) is set when columns i and i+1 differ
+				output += Popcount::count((value ^ (value >> 1)) & innerMask);
+				// Right and left walls are full: add 1 for each empty border block
+				output += (int)(((value & 1) ^ 1) + (((value >> (width - 1)) & 1) ^ 1));
+			}
+			return output;
+		}
+
+		template<class Popcount>
+		TETRISAI_FORCE_INLINE int columnTransitionsKernel(const Row* rows, int rowCount, int width)
+		{
+			// The floor is full and the space above the last row is empty
+			int output(Popcount::count(completeLine(width) ^ RowWord(rows[0])));
+			for (int row = 0; row < rowCount - 1; row++)
+			{
+				output += Popcount::count(RowWord(rows[row] ^ rows[row + 1]));
+			}
+			if (rowCount > 0)
+			{
+				output += Popcount::count(RowWord(rows[rowCount - 1]));
+			}
+			return output;
+		}
+
+		template<class Popcount>
+		TETRISAI_FORCE_INLINE int wellsKernel(const Row* rows, int rowCount, int width)
+		{
+			// For each column, the number of consecutive empty blocks ending at the current row is stored as a
+			// bit-sliced counter: bit c of runPlanes[j] is the j-th bit of the counter of column c
+			const int planes(6); // Enough for runs up to 63 blocks
+			RowWord runPlanes[planes] = { 0, 0, 0, 0, 0, 0 };
+			RowWord fullLine(completeLine(width)), leftWall(RowWord(1) << (width - 1));
+			int output(0);
+
+			for (int row = 0; row < rowCount; row++)
+			{
+				RowWord value(rows[row]);
+				RowWord empty(~value & fullLine);
+
+				// Reset the counters of full blocks and increment the others (ripple carry across the planes)
+				RowWord carry(empty);
+				for (int j = 0; j < planes; j++)
+				{
+					runPlanes[j] &= empty;
+					RowWord nextCarry(runPlanes[j] & carry);
+					runPlanes[j] ^= carry;
+					carry = nextCarry;
+				}
+
+				// A well is an empty block whose left (higher bit) and right (lower bit) neighbours are full or walls
+				RowWord wellTops(empty & ((value >> 1) | leftWall) & ((value << 1) | 1));
+
+				// Each well weighs the length of the run of empty blocks it tops
+				for (int j = 0; j < planes; j++)
+				{
+					output += Popcount::count(wellTops & runPlanes[j]) << j;
+				}
+			}
+			return output;
+		}
+
+		template<class Popcount>
+		TETRISAI_FORCE_INLINE int columnCellarsKernel(const unsigned int* columns, int width)
+		{
+			// Below the top block of a column, every block that is not full is a hole
+			int output(0);
+			for (int col = 0; col < width; col++)
+			{
+				output += bitLength(columns[col]) - Popcount::count(columns[col]);
+			}
+			return output;
+		}
+
+		template<class Popcount>
+		TETRISAI_FORCE_INLINE int columnWellsKernel(const unsigned int* columns, int width, int rowCount)
+		{
+			unsigned int consideredRows(rowCount ? ~0u >> (32 - rowCount) : 0);
+			int output(0);
+			for (int col = 0; col < width; col++)
+			{
+				// Walls are full on every row
+				unsigned int left(col + 1 < width ? columns[col + 1] : ~0u), right(col > 0 ? columns[col - 1] : ~0u);
+				unsigned int wellTops(~columns[col] & left & right & consideredRows);
+				while (wellTops)
+				{
+					// The depth of a well is the distance to the first full block below its top (or to the floor)
+					unsigned int top(wellTops & (~wellTops + 1)); // Lowest well top of the column
+					output += bitLength(top) - bitLength(columns[col] & (top - 1));
+					wellTops ^= top;
+				}
+			}
+			return output;
+		}
+
+		/// <summary>Column compaction without any bit extraction instruction: removed rows are taken out one by one from the highest one</summary>
+		void portableCompactColumns(unsigned int* columns, int width, unsigned int keptRows)
+		{
+			for (unsigned int removedRows = ~keptRows; removedRows; )
+			{
+				int row(bitLength(removedRows) - 1);
+				removedRows ^= 1u << row;
+				unsigned int rowsBelow((1u << row) - 1);
+				for (int col = 0; col < width; col++)
+				{
+					columns[col] = (columns[col] & rowsBelow) | ((columns[col] >> 1) & ~rowsBelow);
+				}
+			}
+		}
+
+		// Portable instantiations
+		int portableActiveBitsCount(std::uint64_t value) { return PortablePopcount::count(value); }
+		int portableBlocksCount(const Row* rows, int rowCount) { return blocksCountKernel<PortablePopcount>(rows, rowCount); }
+		int portableRowTransitions(const Row* rows, int rowCount, int width) { return rowTransitionsKernel<PortablePopcount>(rows, rowCount, width); }
+		int portableColumnTransitions(const Row* rows, int rowCount, int width) { return columnTransitionsKernel<PortablePopcount>(rows, rowCount, width); }
+		int portableWells(const Row* rows, int rowCount, int width) { return wellsKernel<PortablePopcount>(rows, rowCount, width); }
+		int portableColumnCellars(const unsigned int* columns, int width) { return columnCellarsKernel<PortablePopcount>(columns, width); }
+		int portableColumnWells(const unsigned int* columns, int width, int rowCount) { return columnWellsKernel<PortablePopcount>(columns, width, rowCount); }
+
+		const BitKernels portableKernels = {
+			"portable",
+			portableActiveBitsCount,
+			portableBlocksCount,
+			portableRowTransitions,
+			portableColumnTransitions,
+			portableWells,
+			portableColumnCellars,
+			portableColumnWells,
+			portableCompactColumns
+		};
+
+#ifdef TETRISAI_POPCNT_DISPATCH
+		// POPCNT instantiations: the kernels are inlined in functions compiled for the POPCNT instruction set
+		TETRISAI_TARGET_POPCNT int popcntActiveBitsCount(std::uint64_t value) { return HardwarePopcount::count(value); }
+		TETRISAI_TARGET_POPCNT int popcntBlocksCount(const Row* rows, int rowCount) { return blocksCountKernel<HardwarePopcount>(rows, rowCount); }
+		TETRISAI_TARGET_POPCNT int popcntRowTransitions(const Row* rows, int rowCount, int width) { return rowTransitionsKernel<HardwarePopcount>(rows, rowCount, width); }
+		TETRISAI_TARGET_POPCNT int popcntColumnTransitions(const Row* rows, int rowCount, int width) { return columnTransitionsKernel<HardwarePopcount>(rows, rowCount, width); }
+		TETRISAI_TARGET_POPCNT int popcntWells(const Row* rows, int rowCount, int width) { return wellsKernel<HardwarePopcount>(rows, rowCount, width); }
+		TETRISAI_TARGET_POPCNT int popcntColumnCellars(const unsigned int* columns, int width) { return columnCellarsKernel<HardwarePopcount>(columns, width); }
+		TETRISAI_TARGET_POPCNT int popcntColumnWells(const unsigned int* columns, int width, int rowCount) { return columnWellsKernel<HardwarePopcount>(columns, width, rowCount); }
+
+		const BitKernels popcntKernels = {
+			"popcnt",
+			popcntActiveBitsCount,
+			popcntBlocksCount,
+			popcntRowTransitions,
+			popcntColumnTransitions,
+			popcntWells,
+			popcntColumnCellars,
+			popcntColumnWells,
+			portableCompactColumns
+		};
+
+		// BMI2 instantiations: same kernels as with POPCNT, columns being compacted by the parallel bit extraction instruction
+		TETRISAI_TARGET_BMI2 void bmi2CompactColumns(unsigned int* columns, int width, unsigned int keptRows)
+		{
+			for (int col = 0; col < width; col++)
+			{
+				columns[col] = _pext_u32(columns[col], keptRows);
+			}
+		}
+
+		const BitKernels bmi2Kernels = {
+			"popcnt+bmi2",
+			popcntActiveBitsCount,
+			popcntBlocksCount,
+			popcntRowTransitions,
+			popcntColumnTransitions,
+			popcntWells,
+			popcntColumnCellars,
+			popcntColumnWells,
+			bmi2CompactColumns
+		};
+
+		bool cpuSupportsPopcount()
+		{
+#ifdef _MSC_VER
+			int cpuInfo[4];
+			__cpuid(cpuInfo, 1);
+			return (cpuInfo[2] >> 23) & 1; // ECX bit 23 of leaf 1 advertises POPCNT
+#else
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("popcnt");
+#endif
+		}
+
+		bool cpuSupportsBitExtraction()
+		{
+#ifdef _MSC_VER
+			int cpuInfo[4];
+			__cpuidex(cpuInfo, 7, 0);
+			return (cpuInfo[1] >> 8) & 1; // EBX bit 8 of leaf 7 advertises BMI2
+#else
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("bmi2");
+#endif
+		}
+#endif
+
+		const BitKernels& selectKernels()
+		{
+#ifdef TETRISAI_POPCNT_DISPATCH
+			if (cpuSupportsPopcount())
+			{
+				return cpuSupportsBitExtraction() ? bmi2Kernels : popcntKernels;
+			}
+#endif
+			return portableKernels;
+		}
+	}
+
+	const BitKernels& BitKernels::get()
+	{
+		// Selected once, the first time kernels are needed
+		static const BitKernels& kernels(selectKernels());
+		return kernels;
+	}
+
+	const BitKernels& BitKernels::portable()
+	{
+		return portableKernels;
+	}
+
+}
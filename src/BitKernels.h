@@ -0,0 +1,67 @@
+#ifndef TETRISAI_BITKERNELS_H
+#define TETRISAI_BITKERNELS_H
+
+#include <cstdint>
+#include "Row.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace TetrisAI {
+
+	/// <summary>Returns the index of the highest bit set to 1 plus one (0 for a null value), e.g. the height of a column stored as a bitmask</summary>
+	inline int bitLength(unsigned int value)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		return _BitScanReverse(&index, value) ? index + 1 : 0;
+#else
+		return value ? 32 - __builtin_clz(value) : 0;
+#endif
+	}
+
+	/// <summary>
+	/// Set of branch-free kernels computing grid features over whole rows of bits (bit 0 being the rightmost column).
+	/// Rows use the Row type the library is built with, while columns are 32-bit words as grids are at most 32 rows high.
+	/// Several implementations of the set are compiled and the best one supported by the CPU is selected at runtime,
+	/// so that the same binary can use hardware popcount (and bit extraction) on recent hosts and still run on older x86-64 ones
+	/// </summary>
+	struct BitKernels {
+		/// <summary>Name of the implementation (for reporting purposes)</summary>
+		const char* name;
+
+		/// <summary>Returns the count of bits set to 1 in the given value</summary>
+		int(*activeBitsCount)(std::uint64_t value);
+
+		/// <summary>Returns the count of bits set to 1 in the given rows</summary>
+		int(*blocksCount)(const Row* rows, int rowCount);
+
+		/// <summary>Returns the number of transitions between full and empty blocks along the rows (walls count as full blocks)</summary>
+		int(*rowTransitions)(const Row* rows, int rowCount, int width);
+
+		/// <summary>Returns the number of transitions between full and empty blocks along the columns (the floor counts as full and the space above the last row as empty)</summary>
+		int(*columnTransitions)(const Row* rows, int rowCount, int width);
+
+		/// <summary>Returns the sum, for each empty block having full blocks (or walls) on its left and right, of the number of consecutive empty blocks from it downwards</summary>
+		int(*wells)(const Row* rows, int rowCount, int width);
+
+		/// <summary>Returns the number of empty blocks having a full block above them in the same column, columns being given as words (bit r being the block of row r)</summary>
+		int(*columnCellars)(const unsigned int* columns, int width);
+
+		/// <summary>Same as wells, computed from columns words (bit r being the block of row r) for the rows below rowCount</summary>
+		int(*columnWells)(const unsigned int* columns, int width, int rowCount);
+
+		/// <summary>Removes from each column word (bit r being the block of row r) the bits that are not in keptRows and packs the remaining ones towards bit 0</summary>
+		void(*compactColumns)(unsigned int* columns, int width, unsigned int keptRows);
+
+		/// <summary>Returns the kernels best suited to the CPU the program is running on</summary>
+		static const BitKernels& get();
+
+		/// <summary>Returns the kernels that do not rely on any optional instruction</summary>
+		static const BitKernels& portable();
+	};
+
+}
+
+#endif
@@ -0,0 +1,79 @@
+#include "ChanceSampling.h"
+#include "Utilities.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace TetrisAI {
+
+	ChanceSampling::ChanceSampling(unsigned samples, Method method, unsigned seed) : samples(samples), method(method), seed(seed), round(0)
+	{
+		if (samples == 0)
+		{
+			throw std::invalid_argument("A sampled node must expand at least one polyomino.");
+		}
+	}
+
+	void ChanceSampling::choose(std::uint64_t positionHash, unsigned possibleCount, std::vector<Sample>& chosen) const
+	{
+		chosen.clear();
+		if (samples >= possibleCount)
+		{
+			for (unsigned i = 0; i < possibleCount; i++)
+			{
+				chosen.push_back(Sample{ i, 1 });
+			}
+			return;
+		}
+
+		// Each draw is a hash of the position, the seed, the round and the draw number: no generator is shared between the threads
+		std::uint64_t base(hashMix(positionHash ^ hashMix((std::uint64_t(seed) << 32) | round.load(std::memory_order_relaxed))));
+		auto draw = [base](unsigned drawIndex, unsigned range) {
+			return unsigned(hashMix(base + 0x9E3779B97F4A7C15ull * (drawIndex + 1)) % range);
+		};
+
+		if (method == Method::Random)
+		{
+			// Partial Fisher-Yates shuffle of the indices
+			std::vector<unsigned> indices(possibleCount);
+			for (unsigned i = 0; i < possibleCount; i++)
+			{
+				indices[i] = i;
+			}
+			for (unsigned i = 0; i < samples; i++)
+			{
+				std::swap(indices[i], indices[i + draw(i, possibleCount - i)]);
+			}
+			std::sort(indices.begin(), indices.begin() + samples);
+
+			float weight(float(possibleCount) / samples);
+			for (unsigned i = 0; i < samples; i++)
+			{
+				chosen.push_back(Sample{ indices[i], weight });
+			}
+		}
+		else
+		{
+			for (unsigned stratum = 0; stratum < samples; stratum++)
+			{
+				unsigned first(stratum * possibleCount / samples), end((stratum + 1) * possibleCount / samples);
+				chosen.push_back(Sample{ first + draw(stratum, end - first), float(end - first) });
+			}
+		}
+	}
+
+	void ChanceSampling::setRound(unsigned round)
+	{
+		this->round = round;
+	}
+
+	unsigned ChanceSampling::getSamples() const
+	{
+		return samples;
+	}
+
+	ChanceSampling::Method ChanceSampling::getMethod() const
+	{
+		return method;
+	}
+
+}
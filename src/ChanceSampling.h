@@ -0,0 +1,62 @@
+#ifndef TETRISAI_CHANCESAMPLING_H
+#define TETRISAI_CHANCESAMPLING_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace TetrisAI {
+
+	/// <summary>
+	/// Sparse sampling of the nodes whose next polyomino is unknown: only a subset of the possible polyominos is expanded by each of them,
+	/// every PolyominoNode weighing the number of possible polyominos it stands for in the mean of its siblings.
+	///
+	/// The subset only depends on the position, the seed and the round, so that trees built by several threads stay the same. Changing the
+	/// round (e.g. at each decision) draws new subsets for the layers built from then on.
+	/// </summary>
+	class ChanceSampling {
+
+	public:
+		enum class Method {
+			/// <summary>Polyominos drawn uniformly without replacement, each standing for the same share of the possible polyominos</summary>
+			Random,
+			/// <summary>Possible polyominos split in consecutive groups of (almost) equal sizes, one polyomino being drawn in each group and standing for the whole group</summary>
+			Stratified
+		};
+
+		/// <summary>Polyomino expanded by a node</summary>
+		struct Sample {
+			/// <summary>Index in the list of possible polyominos</summary>
+			unsigned index;
+			/// <summary>Number of possible polyominos it stands for</summary>
+			float weight;
+		};
+
+		/// <param name="samples">Number of polyominos expanded by each node (every polyomino is expanded if there are not more of them)</param>
+		/// <param name="method">How the polyominos are chosen</param>
+		/// <param name="seed">Seed of the draws</param>
+		/// <exception cred="std::invalid_argument">Thrown if samples is 0</exception>
+		ChanceSampling(unsigned samples, Method method, unsigned seed = 0);
+
+		/// <summary>Chooses the polyominos expanded by a node, in increasing order of their index</summary>
+		/// <param name="positionHash">Hash of the game state of the node</param>
+		/// <param name="possibleCount">Number of possible polyominos</param>
+		/// <param name="chosen">Receives the polyominos to expand</param>
+		void choose(std::uint64_t positionHash, unsigned possibleCount, std::vector<Sample>& chosen) const;
+
+		/// <summary>Sets the round the next draws depend on</summary>
+		void setRound(unsigned round);
+
+		unsigned getSamples() const;
+		Method getMethod() const;
+
+	private:
+		unsigned samples;
+		Method method;
+		unsigned seed;
+		std::atomic<unsigned> round;
+	};
+
+}
+
+#endif
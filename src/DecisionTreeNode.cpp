@@ -2,6 +2,11 @@
 
 namespace TetrisAI {
 
+	void DecisionTreeNode::updateTree(const Polyomino* newPolyomino, int depth, std::vector<Polyomino>& possiblePolyominos, Heuristic& heuristic, bool useMultithreading)
+	{
+		updateTree(newPolyomino, depth, SearchContext(possiblePolyominos, heuristic), useMultithreading);
+	}
+
 	DecisionTreeNode::NodeStatus DecisionTreeNode::mergeNodesStatus(std::vector<std::unique_ptr<DecisionTreeNode>>& nodes)
 	{
 		NodeStatus output;
@@ -26,4 +31,34 @@ namespace TetrisAI {
 		return output;
 	}
 
-}
\ No newline at end of file
+	void DiscardedNodes::add(std::unique_ptr<DecisionTreeNode> node)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		nodes.push_back(std::move(node));
+	}
+
+	void DiscardedNodes::clear(const std::atomic<bool>* cancellation)
+	{
+		while (cancellation == nullptr || !cancellation->load(std::memory_order_relaxed))
+		{
+			// The subtree is destroyed out of the lock, so that nodes can be added meanwhile
+			std::unique_ptr<DecisionTreeNode> node;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (nodes.empty())
+				{
+					return;
+				}
+				node = std::move(nodes.back());
+				nodes.pop_back();
+			}
+		}
+	}
+
+	bool DiscardedNodes::empty()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return nodes.empty();
+	}
+
+}
@@ -3,9 +3,12 @@
 
 #include "Polyomino.h"
 #include "Heuristic.h"
+#include "SearchContext.h"
 #include <vector>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <string>
 
 namespace TetrisAI {
 
@@ -24,16 +27,27 @@ namespace TetrisAI {
 		/// <param name="possiblePolyominos">List of potential polyominos to populate the decision tree if needed</param>
 		/// <param name="possiblePolyominos">Heuristic that should be used to evaluate leaves and branches</param>
 		/// <param name="useMultithreading">Toggle the use of multithreading to enhance the speed of decision making</param>
-		virtual void updateTree(Polyomino* newPolyomino, int depth, std::vector<Polyomino>& possiblePolyominos, Heuristic& heuristic, bool useMultithreading) = 0;
+		void updateTree(const Polyomino* newPolyomino, int depth, std::vector<Polyomino>& possiblePolyominos, Heuristic& heuristic, bool useMultithreading);
+
+		/// <summary>Update recursively the tree with a new polyomino</summary>
+		/// <param name="newPolyomino">Polyomino that should enter the queue of known pending polyominos</param>
+		/// <param name="depth">Number of moves that should be considered from this node</param>
+		/// <param name="context">Polyominos, heuristic and shared tables used to build and evaluate the nodes</param>
+		/// <param name="useMultithreading">Toggle the use of multithreading to enhance the speed of decision making</param>
+		virtual void updateTree(const Polyomino* newPolyomino, int depth, const SearchContext& context, bool useMultithreading) = 0;
 
 		/// <summary>Returns true if the node is a PolyominoNode that consider the possibility that a certain polyomino will have to be played</summary>
 		/// <param name="polyomino">Polyomino that should be matched</param>
-		virtual bool matchPolyomino(Polyomino* polyomino) = 0;
+		virtual bool matchPolyomino(const Polyomino* polyomino) = 0;
 
 		/// <summary>Helper method to move children from the current node to the given destination</summary>
 		/// <param name="destination">Vector that should retrieve the ownership of the children of the current node</param>
 		virtual void movingChildrenOwnership(std::vector<std::unique_ptr<DecisionTreeNode>>& destination) = 0;
 
+		/// <summary>Drops the subtree below the node, whose evaluation is kept: it is rebuilt if the tree is updated from the node</summary>
+		/// <returns>False if the node had no subtree to drop</returns>
+		virtual bool collapse() = 0;
+
 		/// <summary>Find the child with the best evaluation and hand it over</summary>
 		/// <returns>Unique pointer holding the best child ownership</returns>
 		virtual std::unique_ptr<DecisionTreeNode> extractBestChild() = 0;
@@ -47,14 +61,34 @@ namespace TetrisAI {
 
 		/// <summary>Computes the evaluation of the siblings as a whole (This method is meant to be called iteratively on all siblings at once)</summary>
 		/// <param name="currentEvaluation">Evaluation of the siblings computed before reaching this node</param>
-		/// <param name="nodePosition">Position of the node in the siblings collection</param>
+		/// <param name="siblingsWeight">Sum of the weights of the siblings before this node (its position in the siblings collection if they all weigh 1)</param>
 		/// <returns>The evaluation of the siblings collection up to this node</returns>
-		virtual float computeSiblingsEvaluation(float currentEvaluation, unsigned nodePosition) = 0;
+		virtual float computeSiblingsEvaluation(float currentEvaluation, float siblingsWeight) = 0;
+
+		/// <summary>Returns the weight of the node among its siblings (the number of possible polyominos a sampled PolyominoNode stands for, 1 otherwise)</summary>
+		virtual float getSiblingWeight() const = 0;
 
 	protected:
 		NodeStatus mergeNodesStatus(std::vector<std::unique_ptr<DecisionTreeNode>>& nodes);
 	};
 
+	/// <summary>Subtrees discarded while a tree is updated, kept so that another thread destroys them later (nodes may be added by several threads at once)</summary>
+	class DiscardedNodes {
+
+	public:
+		void add(std::unique_ptr<DecisionTreeNode> node);
+
+		/// <summary>Destroys the discarded subtrees one after the other</summary>
+		/// <param name="cancellation">Flag stopping the destruction once set, the subtrees left being kept (nullptr to destroy every subtree)</param>
+		void clear(const std::atomic<bool>* cancellation = nullptr);
+
+		bool empty();
+
+	private:
+		std::mutex mutex;
+		std::vector<std::unique_ptr<DecisionTreeNode>> nodes;
+	};
+
 }
 
 #endif
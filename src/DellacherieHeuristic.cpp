@@ -34,4 +34,30 @@ namespace TetrisAI {
 		MoveResult moveResult(gs.getMoveResult());
 		return childrenEvaluation + 2 * moveResult.linesCleared * moveResult.pieceVanishedBlocks;
 	}
+
+	bool DellacherieHeuristic::getEvaluationBounds(const GameState& gs, int depth, int squares, Bounds& bounds)
+	{
+		const Grid& grid(gs.getGrid());
+		float width(grid.getWidth()), height(grid.getHeight());
+
+		// The top margin is at most the grid height plus one and every other term is a penalty, bounded by the grid size
+		float lowestPosition(-(2 * (height + 1) + width * (height + 1) + height * (width + 1) + 4 * width * height + width * height * (height + 1) / 2));
+		bounds.lower = lowestPosition < gameOverEvaluation ? lowestPosition : gameOverEvaluation;
+
+		// A piece clears at most as many lines as its squares, and every cleared line is made of blocks of the grid or of the pieces played
+		int lines((grid.getBlocksCount() + depth * squares) / grid.getWidth());
+		lines = lines < depth * squares ? lines : depth * squares;
+		// Each cleared line brings at most 2 * squares, counted twice at most (for the node of the move and for the sub root of a PolyominoNode),
+		// as is the bonus of the move that led to the root
+		MoveResult moveResult(gs.getMoveResult());
+		float rootBonus(2.f * moveResult.linesCleared * moveResult.pieceVanishedBlocks);
+		bounds.upper = height + 1 + 2 * rootBonus + 2 * (2.f * squares * lines);
+		return true;
+	}
+
+	float DellacherieHeuristic::invertBranch(const GameState& gs, float evaluation)
+	{
+		MoveResult moveResult(gs.getMoveResult());
+		return evaluation - 2 * moveResult.linesCleared * moveResult.pieceVanishedBlocks;
+	}
 }
\ No newline at end of file
@@ -9,6 +9,8 @@ namespace TetrisAI {
 	public:
 		virtual float evaluate(const GameState& gs);
 		virtual float evaluateBranch(const GameState& gs, float childrenEvaluation);
+		virtual bool getEvaluationBounds(const GameState& gs, int depth, int squares, Bounds& bounds);
+		virtual float invertBranch(const GameState& gs, float evaluation);
 	};
 
 }
@@ -0,0 +1,237 @@
+#include "ExpectimaxStrategy.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace TetrisAI {
+
+	namespace {
+		const float noAlpha(-std::numeric_limits<float>::infinity());
+
+		/// <summary>Returns the number of squares composing a polyomino (ids are grouped by number of squares)</summary>
+		int squaresOf(const Polyomino& polyomino)
+		{
+			int squares(1);
+			while (squares < Polyomino::maxSquares && polyomino.getId() >= Polyomino::getFirstId(squares + 1))
+			{
+				squares++;
+			}
+			return squares;
+		}
+	}
+
+	ExpectimaxStrategy::ExpectimaxStrategy(Heuristic& heuristic, unsigned int depth, bool usePruning, std::chrono::microseconds timeBudget) :
+		heuristic(heuristic), depth(depth), usePruning(usePruning), timeBudget(timeBudget), statistics(), lastDepth(0),
+		possiblePolyominos(nullptr), squares(0), isPruning(false), hasDeadline(false), isTimeUp(false)
+	{
+		if (depth > maxDepth)
+		{
+			throw std::invalid_argument("An expectimax search cannot consider more than 32 moves at once.");
+		}
+	}
+
+	Transformation ExpectimaxStrategy::decideMove(const GameState& gs, std::vector<Polyomino>& possiblePolyominos)
+	{
+		const Polyomino* comingPolyomino(gs.polyominoQueueHead());
+		if (comingPolyomino == nullptr)
+		{
+			throw std::invalid_argument("Given game state does not have any pending polyomino");
+		}
+
+		// Known polyominos are drawn among the possible ones as well, the coming and the last one are checked in case they are not
+		this->possiblePolyominos = &possiblePolyominos;
+		squares = std::max(squaresOf(*comingPolyomino), squaresOf(*gs.polyominoQueueTail()));
+		for (auto& p : possiblePolyominos)
+		{
+			squares = std::max(squaresOf(p), squares);
+		}
+		Heuristic::Bounds bounds;
+		isPruning = usePruning && heuristic.getEvaluationBounds(gs, depth, squares, bounds);
+
+		std::vector<Placement> placements(gs.getGrid().computePlacements(*comingPolyomino));
+		int bestIndex(-1);
+		if (timeBudget == std::chrono::microseconds::zero())
+		{
+			bestIndex = searchPlacements(gs, placements, depth);
+			lastDepth = depth;
+		}
+		else
+		{
+			// Deeper searches are given up once the budget is spent, keeping the decision of the deepest completed one
+			deadline = Clock::now() + timeBudget;
+			for (unsigned int searchDepth = 1; searchDepth <= depth; searchDepth++)
+			{
+				hasDeadline = searchDepth > 1;
+				isTimeUp = false;
+				int searchBestIndex(searchPlacements(gs, placements, searchDepth));
+				if (isTimeUp)
+				{
+					statistics.abortedSearches++;
+					break;
+				}
+				bestIndex = searchBestIndex;
+				lastDepth = searchDepth;
+			}
+			hasDeadline = false;
+			isTimeUp = false;
+		}
+
+		if (bestIndex < 0)
+		{
+			return Transformation(-1, -1);
+		}
+		GameState bestState(gs);
+		bestState.play(placements[bestIndex]);
+		if (bestState.isGameOver())
+		{
+			return Transformation(-1, -1);
+		}
+		return placements[bestIndex].transformation;
+	}
+
+	ExpectimaxStrategy::Statistics ExpectimaxStrategy::getStatistics() const
+	{
+		return statistics;
+	}
+
+	unsigned int ExpectimaxStrategy::getLastDepth() const
+	{
+		return lastDepth;
+	}
+
+	int ExpectimaxStrategy::searchPlacements(const GameState& gs, const std::vector<Placement>& placements, int depth)
+	{
+		// The root is a GameStateNode whose children are the moves of the coming polyomino: the first best one is chosen
+		statistics.searchedNodes++;
+		float best(0);
+		int bestIndex(-1);
+		for (unsigned i = 0; i < placements.size() && !isTimeUp; i++)
+		{
+			GameState postMoveState(gs);
+			postMoveState.play(placements[i]);
+			bool isUpperBound;
+			float evaluation(search(postMoveState, depth - 1, isPruning && bestIndex >= 0 ? best : noAlpha, isUpperBound));
+			if (!isUpperBound && (bestIndex < 0 || evaluation > best))
+			{
+				best = evaluation;
+				bestIndex = i;
+			}
+		}
+		return isTimeUp ? -1 : bestIndex;
+	}
+
+	float ExpectimaxStrategy::search(const GameState& gs, int depth, float alpha, bool& isUpperBound)
+	{
+		statistics.searchedNodes++;
+		isUpperBound = false;
+
+		// Reading the clock costs about as much as searching a leaf: it is only checked every few hundred nodes
+		if (hasDeadline && (statistics.searchedNodes & 0xFF) == 0 && Clock::now() >= deadline)
+		{
+			isTimeUp = true;
+		}
+		if (isTimeUp)
+		{
+			return 0;
+		}
+
+		// As with a GameStateNode, the heuristic evaluates game overs and nodes that do not consider any more move
+		if (depth <= 0 || gs.isGameOver())
+		{
+			statistics.evaluatedNodes++;
+			return heuristic.evaluate(gs);
+		}
+		if (gs.polyominoQueueHead() == nullptr)
+		{
+			return searchPolyominos(gs, depth, alpha, isUpperBound);
+		}
+		return searchMoves(gs, depth, alpha, isUpperBound);
+	}
+
+	float ExpectimaxStrategy::searchMoves(const GameState& gs, int depth, float alpha, bool& isUpperBound)
+	{
+		std::vector<Placement> placements(gs.getGrid().computePlacements(*gs.polyominoQueueHead()));
+		if (placements.empty())
+		{
+			statistics.evaluatedNodes++;
+			return heuristic.evaluate(gs);
+		}
+
+		// Children below childrenAlpha cannot bring the node above alpha, nor can children below the best one found so far
+		float childrenAlpha(alpha == noAlpha ? noAlpha : heuristic.invertBranch(gs, alpha));
+		float best(0), bestUpperBound(noAlpha);
+		bool hasBest(false), hasUpperBound(false);
+		for (unsigned i = 0; i < placements.size() && !isTimeUp; i++)
+		{
+			const Placement& placement(placements[i]);
+			GameState postMoveState(gs);
+			postMoveState.play(placement);
+			bool childIsUpperBound;
+			float childAlpha(isPruning && hasBest && best > childrenAlpha ? best : childrenAlpha);
+			float evaluation(search(postMoveState, depth - 1, childAlpha, childIsUpperBound));
+			if (childIsUpperBound)
+			{
+				hasUpperBound = true;
+				bestUpperBound = evaluation > bestUpperBound ? evaluation : bestUpperBound;
+			}
+			else if (!hasBest || evaluation > best)
+			{
+				best = evaluation;
+				hasBest = true;
+			}
+		}
+
+		// Cut children are below their alpha: they can only be ignored if the best child reached childrenAlpha
+		if (hasUpperBound && (!hasBest || best < childrenAlpha))
+		{
+			isUpperBound = true;
+			return heuristic.evaluateBranch(gs, hasBest && best > bestUpperBound ? best : bestUpperBound);
+		}
+		return heuristic.evaluateBranch(gs, best);
+	}
+
+	float ExpectimaxStrategy::searchPolyominos(const GameState& gs, int depth, float alpha, bool& isUpperBound)
+	{
+		std::vector<Polyomino>& polyominos(*possiblePolyominos);
+		if (polyominos.empty())
+		{
+			statistics.evaluatedNodes++;
+			return heuristic.evaluate(gs);
+		}
+
+		Heuristic::Bounds bounds;
+		bool canPrune(isPruning && alpha != noAlpha && heuristic.getEvaluationBounds(gs, depth, squares, bounds));
+		float childrenAlpha(canPrune ? heuristic.invertBranch(gs, alpha) : noAlpha);
+		// Bounds are computed in another order than the means of an exhaustive search: they must be below alpha by more than their rounding errors
+		float margin(canPrune ? 1e-5f * (1 + std::max(std::abs(bounds.lower), std::abs(bounds.upper))) : 0);
+
+		unsigned count(polyominos.size());
+		double sum(0);
+		float childrenEvaluation(0);
+		for (unsigned i = 0; i < count && !isTimeUp; i++)
+		{
+			GameState subState(gs);
+			subState.addPolyominoToQueue(&polyominos[i]);
+
+			// Even if every remaining polyomino reached the upper bound, a child below childAlpha would keep the mean below childrenAlpha
+			unsigned remaining(count - i - 1);
+			float childAlpha(canPrune ? float(count * double(childrenAlpha) - sum - remaining * double(bounds.upper)) : noAlpha);
+			bool childIsUpperBound;
+			float evaluation(search(subState, depth, childAlpha, childIsUpperBound));
+			if (canPrune && (childIsUpperBound || evaluation < childAlpha - margin))
+			{
+				statistics.cutoffs += remaining > 0 ? 1 : 0;
+				statistics.prunedSubtrees += remaining;
+				isUpperBound = true;
+				return heuristic.evaluateBranch(gs, float((sum + evaluation + remaining * double(bounds.upper)) / count));
+			}
+
+			// Same iterative mean as PolyominoNode::computeSiblingsEvaluation, so that the evaluation is exactly the one of the decision tree
+			sum += evaluation;
+			childrenEvaluation = (i * childrenEvaluation + evaluation) / (i + 1);
+		}
+		return heuristic.evaluateBranch(gs, childrenEvaluation);
+	}
+
+}
@@ -0,0 +1,105 @@
+#ifndef TETRISAI_EXPECTIMAXSTRATEGY_H
+#define TETRISAI_EXPECTIMAXSTRATEGY_H
+
+#include <chrono>
+#include "AIStrategy.h"
+#include "Heuristic.h"
+
+namespace TetrisAI {
+
+	/// <summary>
+	/// Strategy taking the same decisions as a decision tree of GameStateNodes and PolyominoNodes freshly built from each game state,
+	/// by searching the tree depth first without storing it.
+	///
+	/// With pruning, the search skips the subtrees that cannot change the decision (Star1 pruning of expectimax trees): a PolyominoNode
+	/// layer averages the evaluations of every possible polyomino, so once the first polyominos are searched, the bounds of the heuristic
+	/// bound the mean. When even the highest evaluation of the remaining polyominos could not bring the mean above an evaluation already
+	/// reached by another move, the remaining polyominos are skipped. The decisions are the same as with an exhaustive search.
+	/// </summary>
+	/// <remarks>
+	/// With a time budget, the search is deepened iteratively (one move, then two moves and so on up to the depth) until the budget
+	/// is spent, the decision being the one of the deepest search completed. The search of a single move is always completed.
+	///
+	/// Star2 probing is not used: there is no minimizing player, so no lower bound of a node is ever enough to skip its siblings
+	/// </remarks>
+	class ExpectimaxStrategy : public AIStrategy {
+
+	public:
+		/// <summary>Largest number of moves considered in advance (nothing is stored along the search and the polyominos of a state are queued one move at a time)</summary>
+		const static int maxDepth = 32;
+
+		/// <summary>Measures collected since the strategy was built</summary>
+		struct Statistics {
+			/// <summary>Number of game states searched (the GameStateNodes of the equivalent decision tree)</summary>
+			unsigned long long searchedNodes;
+			/// <summary>Number of game states evaluated by the heuristic (the leaves)</summary>
+			unsigned long long evaluatedNodes;
+			/// <summary>Number of PolyominoNode layers whose search stopped before their last polyomino</summary>
+			unsigned long long cutoffs;
+			/// <summary>Number of polyominos skipped by these cutoffs, each of them the root of a subtree that was not searched</summary>
+			unsigned long long prunedSubtrees;
+			/// <summary>Number of searches given up because the time budget of their move was spent</summary>
+			unsigned long long abortedSearches;
+		};
+
+		/// <param name="heuristic">Heuristic that should be used to evaluate the nodes</param>
+		/// <param name="depth">Number of moves to be considered in advance</param>
+		/// <param name="usePruning">Whether subtrees that cannot change the decision are skipped (only if the heuristic bounds its evaluations)</param>
+		/// <param name="timeBudget">Time after which the deepening of the search stops (zero to search depth moves at once, whatever the time it takes)</param>
+		/// <exception cred="std::invalid_argument">Thrown if depth exceeds maxDepth</exception>
+		ExpectimaxStrategy(Heuristic& heuristic, unsigned int depth, bool usePruning = true, std::chrono::microseconds timeBudget = std::chrono::microseconds::zero());
+
+		/// <summary>Evaluate the possible outcomes from the given game state and outputs the best moves based on an heuristic</summary>
+		/// <param name="gs">Game state which should have at least one pending polyomino to be played</param>
+		/// <param name="possiblePolyominos">List of potential polyominos to consider when the next polyomino is unknown</param>
+		virtual Transformation decideMove(const GameState& gs, std::vector<Polyomino>& possiblePolyominos);
+
+		Statistics getStatistics() const;
+
+		/// <summary>Returns the number of moves considered by the last decision (lower than the depth if the time budget was spent)</summary>
+		unsigned int getLastDepth() const;
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		/// <summary>Heuristic that should be used to evaluate game states</summary>
+		Heuristic& heuristic;
+		/// <summary>Number of moves to be considered in advance</summary>
+		unsigned int depth;
+		bool usePruning;
+		std::chrono::microseconds timeBudget;
+		Statistics statistics;
+		unsigned int lastDepth;
+
+		// Set for the duration of a decision
+		std::vector<Polyomino>* possiblePolyominos;
+		/// <summary>Largest number of squares of the possible polyominos</summary>
+		int squares;
+		/// <summary>Whether subtrees are pruned (the heuristic may not bound its evaluations)</summary>
+		bool isPruning;
+		/// <summary>Whether the search should be given up once the deadline passes</summary>
+		bool hasDeadline;
+		Clock::time_point deadline;
+		/// <summary>Set once the deadline passed: the search then returns as soon as possible and its result is meaningless</summary>
+		bool isTimeUp;
+
+		/// <summary>Searches every move of the coming polyomino, considering depth moves</summary>
+		/// <returns>Index of the first best placement (-1 if there is none or if the time is up)</returns>
+		int searchPlacements(const GameState& gs, const std::vector<Placement>& placements, int depth);
+
+		/// <summary>Computes the evaluation of the GameStateNode of a game state</summary>
+		/// <param name="depth">Number of moves considered from the game state</param>
+		/// <param name="alpha">Evaluation below which the exact evaluation of the node does not matter (-infinity if it always does)</param>
+		/// <param name="isUpperBound">Set to true if the search was cut: the returned value is then only an upper bound of the evaluation, which is below alpha</param>
+		float search(const GameState& gs, int depth, float alpha, bool& isUpperBound);
+
+		/// <summary>Search of a node whose next polyomino is known: its evaluation is based on the best move</summary>
+		float searchMoves(const GameState& gs, int depth, float alpha, bool& isUpperBound);
+
+		/// <summary>Search of a node whose next polyomino is unknown: its evaluation is based on the mean over the possible polyominos</summary>
+		float searchPolyominos(const GameState& gs, int depth, float alpha, bool& isUpperBound);
+	};
+
+}
+
+#endif
@@ -0,0 +1,389 @@
+#include "FlatTreeStrategy.h"
+#include <stdexcept>
+
+namespace TetrisAI {
+
+	namespace {
+
+		/// <summary>Moves the flagged elements at the front of the vector, in order, and drops the other ones</summary>
+		template <typename T>
+		void compact(std::vector<T>& values, const std::vector<bool>& keep)
+		{
+			std::size_t kept(0);
+			for (std::size_t i = 0; i < values.size(); i++)
+			{
+				if (keep[i])
+				{
+					if (kept != i)
+					{
+						values[kept] = std::move(values[i]);
+					}
+					kept++;
+				}
+			}
+			values.erase(values.begin() + kept, values.end());
+		}
+	}
+
+	std::size_t FlatTreeStrategy::Level::size() const
+	{
+		return evaluations.size();
+	}
+
+	void FlatTreeStrategy::Level::push(const GameState& state, Transformation move)
+	{
+		states.push_back(state);
+		evaluations.push_back(0);
+		moves.push_back(move);
+		firstChild.push_back(0);
+		childCount.push_back(0);
+	}
+
+	void FlatTreeStrategy::Level::pushLeaf(Transformation move, float evaluation)
+	{
+		evaluations.push_back(evaluation);
+		moves.push_back(move);
+		firstChild.push_back(0);
+		childCount.push_back(0);
+	}
+
+	void FlatTreeStrategy::Level::clear()
+	{
+		states.clear();
+		evaluations.clear();
+		moves.clear();
+		firstChild.clear();
+		childCount.clear();
+	}
+
+	FlatTreeStrategy::FlatTreeStrategy(Heuristic& heuristic, unsigned int depth) : heuristic(heuristic), depth(depth)
+	{
+		if (depth > maxDepth)
+		{
+			throw std::invalid_argument("This implementation does not allow decision trees to consider more than 4 moves at once.");
+		}
+	}
+
+	Transformation FlatTreeStrategy::decideMove(const GameState& gs, std::vector<Polyomino>& possiblePolyominos)
+	{
+		if (levels.empty())
+		{
+			Level root(takeSpareLevel());
+			root.kind = NodeKind::Move;
+			root.push(gs, gs.getPolyominoMove());
+			levels.push_back(std::move(root));
+		}
+		else
+		{
+			const Polyomino* lastAddedPolyomino(gs.polyominoQueueTail());
+			if (lastAddedPolyomino == nullptr)
+			{
+				throw std::invalid_argument("Given game state does not have any pending polyomino");
+			}
+			addPolyomino(lastAddedPolyomino);
+		}
+
+		extendTree(possiblePolyominos);
+		updateEvaluations();
+
+		// The polyomino at the head of the root queue is known: the children of the root are the moves that can be played
+		if (levels.size() < 2)
+		{
+			releaseLevel(0);
+			return Transformation(-1, -1);
+		}
+
+		// When the children of the root are the last level, their states are needed to know whether the best move is a game over
+		if (levels[1].states.empty())
+		{
+			materializeStates(1);
+		}
+		const Level& moves(levels[1]);
+		std::size_t best(0);
+		for (std::size_t i = 1; i < moves.size(); i++)
+		{
+			if (moves.evaluations[i] > moves.evaluations[best])
+			{
+				best = i;
+			}
+		}
+		bool isGameOver(moves.states[best].isGameOver());
+		Transformation bestMove(moves.moves[best]);
+
+		// The best child becomes the root: every other branch is dropped
+		std::vector<bool> keep(moves.size(), false);
+		keep[best] = true;
+		keepSubtrees(1, keep);
+		releaseLevel(0);
+
+		if (isGameOver)
+		{
+			return Transformation(-1, -1);
+		}
+		return bestMove;
+	}
+
+	std::size_t FlatTreeStrategy::getNodeCount() const
+	{
+		std::size_t count(0);
+		for (auto& level : levels)
+		{
+			count += level.size();
+		}
+		return count;
+	}
+
+	FlatTreeStrategy::Level FlatTreeStrategy::takeSpareLevel()
+	{
+		if (spareLevels.empty())
+		{
+			return Level();
+		}
+		Level level(std::move(spareLevels.back()));
+		spareLevels.pop_back();
+		return level;
+	}
+
+	void FlatTreeStrategy::releaseLevel(unsigned level)
+	{
+		levels[level].clear();
+		spareLevels.push_back(std::move(levels[level]));
+		levels.erase(levels.begin() + level);
+	}
+
+	void FlatTreeStrategy::addPolyomino(const Polyomino* polyomino)
+	{
+		// Nodes of the first Draw level (and their descendants) already considered a polyomino at that position of the queue
+		unsigned drawLevel(1);
+		while (drawLevel < levels.size() && levels[drawLevel].kind != NodeKind::Draw)
+		{
+			drawLevel++;
+		}
+
+		for (unsigned l = 0; l < drawLevel && l < levels.size(); l++)
+		{
+			for (auto& state : levels[l].states)
+			{
+				state.addPolyominoToQueue(polyomino);
+			}
+		}
+
+		if (drawLevel >= levels.size())
+		{
+			return;
+		}
+
+		// The polyomino is now known: each parent of the Draw level only keeps the branch of its matching child, which is then skipped
+		Level& parents(levels[drawLevel - 1]);
+		Level& draws(levels[drawLevel]);
+		std::vector<bool> keep(draws.size(), false);
+		for (std::size_t i = 0; i < parents.size(); i++)
+		{
+			bool hasMatch(false);
+			for (std::uint32_t child = parents.firstChild[i]; child < parents.firstChild[i] + parents.childCount[i]; child++)
+			{
+				if (draws.states[child].polyominoQueueTail()->getId() == polyomino->getId())
+				{
+					keep[child] = true;
+					hasMatch = true;
+					break;
+				}
+			}
+			if (parents.childCount[i] > 0 && !hasMatch)
+			{
+				throw std::runtime_error("Error:  could not find a match for a certain polyomino in the tree decision. Tree state unexpected. This layer should be composed of one Draw node for each possible polyomino.");
+			}
+		}
+
+		keepSubtrees(drawLevel, keep);
+		if (drawLevel >= levels.size())
+		{
+			return; // None of the parents had children (they are all game overs)
+		}
+		std::size_t match(0);
+		for (std::size_t i = 0; i < parents.size(); i++)
+		{
+			if (parents.childCount[i] > 0)
+			{
+				parents.firstChild[i] = draws.firstChild[match];
+				parents.childCount[i] = draws.childCount[match];
+				match++;
+			}
+		}
+		releaseLevel(drawLevel);
+	}
+
+	void FlatTreeStrategy::materializeStates(unsigned level)
+	{
+		const Level& parents(levels[level - 1]);
+		Level& nodes(levels[level]);
+		for (std::size_t i = 0; i < parents.size(); i++)
+		{
+			for (std::uint32_t child = parents.firstChild[i]; child < parents.firstChild[i] + parents.childCount[i]; child++)
+			{
+				nodes.states.push_back(parents.states[i]);
+				nodes.states.back().play(nodes.moves[child]);
+			}
+		}
+	}
+
+	void FlatTreeStrategy::extendTree(std::vector<Polyomino>& possiblePolyominos)
+	{
+		// Draw nodes consider the same move as their parent, Move nodes consider one move less
+		levels[0].depth = depth;
+		for (unsigned l = 1; l < levels.size(); l++)
+		{
+			levels[l].depth = levels[l].kind == NodeKind::Draw ? levels[l - 1].depth : levels[l - 1].depth - 1;
+		}
+
+		while (levels.back().depth > 0)
+		{
+			if (levels.back().states.empty())
+			{
+				materializeStates(levels.size() - 1);
+			}
+
+			Level children(takeSpareLevel());
+			Level& parents(levels.back());
+			// Every node of a level has the same number of known polyominos: if the next one is unknown, every possible polyomino is considered
+			children.kind = parents.states[0].getPolyominoQueueSize() == 0 ? NodeKind::Draw : NodeKind::Move;
+			children.depth = children.kind == NodeKind::Draw ? parents.depth : parents.depth - 1;
+
+			for (std::size_t i = 0; i < parents.size(); i++)
+			{
+				const GameState& state(parents.states[i]);
+				parents.firstChild[i] = children.size();
+				if (state.isGameOver())
+				{
+					continue;
+				}
+
+				if (children.kind == NodeKind::Draw)
+				{
+					for (auto& p : possiblePolyominos)
+					{
+						children.push(state, Transformation());
+						children.states.back().addPolyominoToQueue(&p);
+					}
+				}
+				else if (children.depth > 0)
+				{
+					std::vector<Placement> placements(state.getGrid().computePlacements(*state.polyominoQueueHead()));
+					for (auto& placement : placements)
+					{
+						children.push(state, placement.transformation);
+						children.states.back().play(placement);
+					}
+				}
+				else
+				{
+					// Leaves are evaluated while their state is at hand, then only their move is kept
+					std::vector<Placement> placements(state.getGrid().computePlacements(*state.polyominoQueueHead()));
+					for (auto& placement : placements)
+					{
+						GameState postMoveState(state);
+						postMoveState.play(placement);
+						children.pushLeaf(placement.transformation, heuristic.evaluate(postMoveState));
+					}
+				}
+				parents.childCount[i] = children.size() - parents.firstChild[i];
+			}
+
+			if (children.size() == 0)
+			{
+				spareLevels.push_back(std::move(children));
+				break;
+			}
+			levels.push_back(std::move(children));
+		}
+	}
+
+	void FlatTreeStrategy::updateEvaluations()
+	{
+		for (std::size_t l = levels.size(); l-- > 0;)
+		{
+			Level& level(levels[l]);
+			if (level.states.empty())
+			{
+				continue; // Leaves evaluated when they were built
+			}
+
+			const Level* children(l + 1 < levels.size() ? &levels[l + 1] : nullptr);
+			for (std::size_t i = 0; i < level.size(); i++)
+			{
+				if (level.childCount[i] == 0)
+				{
+					level.evaluations[i] = heuristic.evaluate(level.states[i]);
+					continue;
+				}
+
+				// The best move is kept among Move children while Draw children are averaged (same computation as computeSiblingsEvaluation)
+				const float* evaluations(&children->evaluations[level.firstChild[i]]);
+				float childrenEvaluation(evaluations[0]);
+				if (children->kind == NodeKind::Draw)
+				{
+					for (std::uint32_t position = 1; position < level.childCount[i]; position++)
+					{
+						childrenEvaluation = (position * childrenEvaluation + evaluations[position]) / (position + 1);
+					}
+				}
+				else
+				{
+					for (std::uint32_t position = 1; position < level.childCount[i]; position++)
+					{
+						childrenEvaluation = evaluations[position] > childrenEvaluation ? evaluations[position] : childrenEvaluation;
+					}
+				}
+				level.evaluations[i] = heuristic.evaluateBranch(level.states[i], childrenEvaluation);
+			}
+		}
+	}
+
+	void FlatTreeStrategy::keepSubtrees(unsigned first, std::vector<bool> keep)
+	{
+		for (unsigned l = first; l < levels.size(); l++)
+		{
+			Level& level(levels[l]);
+			std::vector<bool> keepChildren;
+			if (l + 1 < levels.size())
+			{
+				// Children of the kept nodes are kept, then their indices are shifted by the number of dropped nodes before them
+				keepChildren.assign(levels[l + 1].size(), false);
+				for (std::size_t i = 0; i < level.size(); i++)
+				{
+					for (std::uint32_t child = level.firstChild[i]; keep[i] && child < level.firstChild[i] + level.childCount[i]; child++)
+					{
+						keepChildren[child] = true;
+					}
+				}
+
+				std::vector<std::uint32_t> keptBefore(keepChildren.size() + 1, 0);
+				for (std::size_t child = 0; child < keepChildren.size(); child++)
+				{
+					keptBefore[child + 1] = keptBefore[child] + (keepChildren[child] ? 1 : 0);
+				}
+				for (std::size_t i = 0; i < level.size(); i++)
+				{
+					level.firstChild[i] = keep[i] ? keptBefore[level.firstChild[i]] : 0;
+				}
+			}
+
+			if (!level.states.empty())
+			{
+				compact(level.states, keep);
+			}
+			compact(level.evaluations, keep);
+			compact(level.moves, keep);
+			compact(level.firstChild, keep);
+			compact(level.childCount, keep);
+			keep.swap(keepChildren);
+		}
+
+		// Levels left without any node are dropped
+		while (levels.size() > first && levels.back().size() == 0)
+		{
+			releaseLevel(levels.size() - 1);
+		}
+	}
+
+}
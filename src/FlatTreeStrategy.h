@@ -0,0 +1,106 @@
+#ifndef TETRISAI_FLATTREESTRATEGY_H
+#define TETRISAI_FLATTREESTRATEGY_H
+
+#include <cstdint>
+#include <vector>
+#include "AIStrategy.h"
+#include "Heuristic.h"
+
+namespace TetrisAI {
+
+	/// <summary>
+	/// Strategy taking the same decisions as a decision tree of GameStateNodes and PolyominoNodes freshly built from each game state,
+	/// but storing the tree level by level in contiguous arrays instead of nodes linked by pointers.
+	///
+	/// Children of a node are contiguous in the next level, and the descendants of a node form a contiguous range of each level:
+	/// evaluations are backed up by linear scans of the levels from the bottom one, and keeping a subtree only compacts the arrays.
+	/// As with HeuristicStrategy, the tree is kept between decisions and only its new levels are built. The leaves of the last level,
+	/// by far the most numerous nodes, are evaluated as they are built and only keep their move: their game state is rebuilt from
+	/// their parent if they are extended later.
+	/// </summary>
+	class FlatTreeStrategy : public AIStrategy {
+
+	public:
+		const static int maxDepth = 4;
+
+		/// <param name="heuristic">Heuristic that should be used to evaluate the nodes</param>
+		/// <param name="depth">Number of moves to be considered in advance</param>
+		/// <exception cred="std::invalid_argument">Thrown if depth exceeds maxDepth</exception>
+		FlatTreeStrategy(Heuristic& heuristic, unsigned int depth);
+
+		/// <summary>Evaluate the possible outcomes from the given game state and outputs the best moves based on an heuristic</summary>
+		/// <param name="gs">Game state which should have at least one pending polyomino to be played</param>
+		/// <param name="possiblePolyominos">List of potential polyominos to populate the decision tree if needed</param>
+		virtual Transformation decideMove(const GameState& gs, std::vector<Polyomino>& possiblePolyominos);
+
+		/// <summary>Returns the number of nodes of the tree kept after the last decision</summary>
+		std::size_t getNodeCount() const;
+
+	private:
+		enum class NodeKind : std::uint8_t {
+			/// <summary>Node reached by playing a move (as a GameStateNode)</summary>
+			Move,
+			/// <summary>Node considering that a certain polyomino is drawn next (as a PolyominoNode along with its sub root)</summary>
+			Draw
+		};
+
+		/// <summary>Nodes sharing the same distance to the root, stored as one array per field</summary>
+		struct Level {
+			/// <summary>Kind of every node of the level: all of them have the same number of known polyominos</summary>
+			NodeKind kind;
+			/// <summary>Number of moves considered from the nodes of the level</summary>
+			int depth;
+			/// <summary>Game state of each node, left empty for the last level as long as its nodes are leaves (see materializeStates)</summary>
+			std::vector<GameState> states;
+			std::vector<float> evaluations;
+			/// <summary>Move that led to each node (only meaningful for Move nodes)</summary>
+			std::vector<Transformation> moves;
+			/// <summary>Index in the next level of the first child of each node</summary>
+			std::vector<std::uint32_t> firstChild;
+			std::vector<std::uint32_t> childCount;
+
+			std::size_t size() const;
+			void push(const GameState& state, Transformation move);
+			/// <summary>Adds a leaf without storing its game state</summary>
+			void pushLeaf(Transformation move, float evaluation);
+			/// <summary>Removes every node while keeping the memory of the arrays</summary>
+			void clear();
+		};
+
+		/// <summary>Heuristic that should be used to evaluate game states</summary>
+		Heuristic& heuristic;
+		/// <summary>Number of moves to be considered in advance</summary>
+		unsigned int depth;
+		/// <summary>Levels of the tree, the first one holding the root only</summary>
+		std::vector<Level> levels;
+		/// <summary>Emptied levels whose arrays are reused by the next levels built, so that the tree does not request new memory at every decision</summary>
+		std::vector<Level> spareLevels;
+
+		/// <summary>Returns an empty level, reusing a spare one if possible</summary>
+		Level takeSpareLevel();
+
+		/// <summary>Removes a level of the tree and keeps its arrays for later levels</summary>
+		void releaseLevel(unsigned level);
+
+		/// <summary>Adds the polyomino to the queue of every node that did not consider it yet, keeping only the branch of the Draw level that matches it</summary>
+		void addPolyomino(const Polyomino* polyomino);
+
+		/// <summary>Rebuilds the game states of a level of Move nodes by playing their move from the state of their parent</summary>
+		void materializeStates(unsigned level);
+
+		/// <summary>Builds new levels below the last one until the nodes of the last level do not have any move left to consider</summary>
+		void extendTree(std::vector<Polyomino>& possiblePolyominos);
+
+		/// <summary>Evaluates the leaves with the heuristic (except those of the last level, evaluated as they are built) and backs the evaluations up to the root, level by level</summary>
+		void updateEvaluations();
+
+		/// <summary>Keeps only the flagged nodes of a level along with their descendants</summary>
+		/// <param name="first">Level of the flagged nodes</param>
+		/// <param name="keep">One flag per node of that level</param>
+		/// <remarks>Parents of the level keep referencing their children by index: they have to be updated by the caller</remarks>
+		void keepSubtrees(unsigned first, std::vector<bool> keep);
+	};
+
+}
+
+#endif
@@ -5,10 +5,10 @@
 
 namespace TetrisAI {
 
-	GameSequence::GameSequence(short gridWidth, short gridHeight, unsigned int polyominoSquares, std::shared_ptr<AIStrategy> strategy, unsigned int stepsAhead) :
-		gridWidth(gridWidth), gridHeight(gridHeight), polyominoSquares(polyominoSquares),
-		strategy(strategy), stats(polyominoSquares), status(Status::New),
-		gameState(gridWidth, gridHeight), stepsAhead(stepsAhead)
+	GameSequence::GameSequence(short gridWidth, short gridHeight, unsigned int polyominoSquares, std::shared_ptr<AIStrategy> strategy, unsigned int stepsAhead, Grid::Layout gridLayout) :
+		gridWidth(gridWidth), gridHeight(gridHeight), polyominoSquares(polyominoSquares), polyominos(Polyomino::getPolyominosList(polyominoSquares)),
+		strategy(strategy), stats(polyominoSquares, polyominos.size()), status(Status::New),
+		gameState(gridWidth, gridHeight, gridLayout), stepsAhead(stepsAhead)
 	{
 		if (stepsAhead > maxStepsAhead)
 		{
@@ -65,8 +65,6 @@ namespace TetrisAI {
 	{
 		srand(static_cast<unsigned int>(time(NULL)));
 		status = GameSequence::Status::Playing;
-		std::vector<Polyomino> polyominos(Polyomino::getPolyominosList(polyominoSquares));
-		stats.polyominosBreakdown = std::vector<unsigned int>(polyominos.size());
 
 		int currentPolyominoIndex(0);
 		
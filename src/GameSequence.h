@@ -22,13 +22,16 @@ namespace TetrisAI {
 		/// <summary>Entry i contains the number of times the polyomino indexed at i has been played</summary>
 		std::vector<unsigned int> polyominosBreakdown;
 
-		GameStatistics(unsigned int polyominosSquares) : polyominosPlayed(0), linesCleared(0), linesClearedBreakdown(polyominosSquares) {}
+		GameStatistics(unsigned int polyominosSquares, unsigned int polyominosCount) :
+			polyominosPlayed(0), linesCleared(0), linesClearedBreakdown(polyominosSquares), polyominosBreakdown(polyominosCount) {}
 	};
 
 	class GameSequence {
 
 	public:
 		const static unsigned maxStepsAhead = 5;
+		// The queue holds the known polyominos, the one being played and the one a decision tree may add while considering the next move
+		static_assert(maxStepsAhead + 2 <= GameState::maxQueueSize, "The game state queue can't hold all the known polyominos");
 
 		enum Status {
 			New,
@@ -36,7 +39,7 @@ namespace TetrisAI {
 			GameOver
 		};
 
-		GameSequence(short gridWidth, short gridHeight, unsigned int polyominoSquares, std::shared_ptr<AIStrategy> strategy, unsigned int stepsAhead);
+		GameSequence(short gridWidth, short gridHeight, unsigned int polyominoSquares, std::shared_ptr<AIStrategy> strategy, unsigned int stepsAhead, Grid::Layout gridLayout = Grid::Layout::RowMajor);
 
 		// Those getters return values since we may have concurrency problem
 		const GameStatistics getStats() const;
@@ -54,6 +57,8 @@ namespace TetrisAI {
 
 		/// <summary>Number of squares that should compose the polyominos used for the game</summary>
 		unsigned int polyominoSquares;
+		/// <summary>Polyominos that can be drawn during the game, taken once from the catalog</summary>
+		std::vector<Polyomino> polyominos;
 		/// <summary>Number of polyominos known in advance during the game (e.g. if set to 0, the next polyomino is unknown)</summary>
 		unsigned int stepsAhead;
 		short gridWidth;
@@ -1,18 +1,23 @@
 #include "GameState.h"
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+#include "Utilities.h"
 
 namespace TetrisAI {
 
 
-	GameState::GameState(short width, short height) : grid(width, height), playedPolyomino(nullptr) {}
+	GameState::GameState(short width, short height, Grid::Layout layout) : grid(width, height, layout), playedPolyomino(nullptr), polyominoQueue(), polyominoQueueSize(0) {}
 	GameState::GameState(const GameState &original) : 
 		grid(original.grid), 
 		moveResult(original.moveResult),
 		playedPolyomino(original.playedPolyomino),
 		polyominoMove(original.polyominoMove),
-		polyominoQueue(original.polyominoQueue)
+		polyominoQueue(original.polyominoQueue),
+		polyominoQueueSize(original.polyominoQueueSize)
 	{}
 
-	const std::vector<unsigned int>& GameState::getGridContent() const
+	std::vector<Row> GameState::getGridContent() const
 	{
 		return grid.getContent();
 	}
@@ -41,7 +46,7 @@ namespace TetrisAI {
 	{
 		// Reset state values
 		playedPolyomino = polyominoQueueHead();
-		polyominoQueue.pop_front(); // Delete it from the queue as we will use it here
+		popPolyominoQueueHead(); // Delete it from the queue as we will use it here
 		polyominoMove = transformation;
 		moveResult = grid.fitPiece(*playedPolyomino, transformation);
 
@@ -49,35 +54,70 @@ namespace TetrisAI {
 		return !moveResult.gameOver;
 	}
 
+	bool GameState::play(const Placement& placement)
+	{
+		playedPolyomino = polyominoQueueHead();
+		popPolyominoQueueHead();
+		polyominoMove = placement.transformation;
+		moveResult = grid.fitPiece(*playedPolyomino, placement);
+
+		return !moveResult.gameOver;
+	}
+
+	std::uint64_t GameState::getHash() const
+	{
+		std::uint64_t output(grid.getHash());
+		for (int index = 0; index < polyominoQueueSize; index++)
+		{
+			output = hashMix(output ^ (polyominoQueue[index] + 1u));
+		}
+		return output;
+	}
+
 	bool GameState::isGameOver() const
 	{
 		return moveResult.gameOver;
 	}
 
-	void GameState::addPolyominoToQueue(Polyomino* polyomino)
+	void GameState::addPolyominoToQueue(const Polyomino* polyomino)
+	{
+		addPolyominoToQueue(polyomino->getId());
+	}
+
+	void GameState::addPolyominoToQueue(PolyominoId polyomino)
+	{
+		if (polyominoQueueSize == maxQueueSize)
+		{
+			throw std::invalid_argument("The queue of known polyominos is full");
+		}
+		polyominoQueue[polyominoQueueSize++] = polyomino;
+	}
+
+	void GameState::popPolyominoQueueHead()
 	{
-		polyominoQueue.push_back(polyomino);
+		std::copy(polyominoQueue.begin() + 1, polyominoQueue.begin() + polyominoQueueSize, polyominoQueue.begin());
+		polyominoQueueSize--;
 	}
 
 	int GameState::getPolyominoQueueSize() const
 	{
-		return polyominoQueue.size();
+		return polyominoQueueSize;
 	}
 
-	Polyomino* GameState::polyominoQueueHead() const
+	const Polyomino* GameState::polyominoQueueHead() const
 	{
-		if (!polyominoQueue.empty())
+		if (polyominoQueueSize > 0)
 		{
-			return polyominoQueue.front();
+			return &Polyomino::fromId(polyominoQueue[0]);
 		}
 		return nullptr;
 	}
 
-	Polyomino* GameState::polyominoQueueTail() const
+	const Polyomino* GameState::polyominoQueueTail() const
 	{
-		if (!polyominoQueue.empty())
+		if (polyominoQueueSize > 0)
 		{
-			return polyominoQueue.back();
+			return &Polyomino::fromId(polyominoQueue[polyominoQueueSize - 1]);
 		}
 		return nullptr;
 	}
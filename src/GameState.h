@@ -2,7 +2,7 @@
 #define TETRISAI_GAMESTATE_H
 
 #include <vector>
-#include <deque>
+#include <array>
 #include "Polyomino.h"
 #include "MoveResult.h"
 #include "Grid.h"
@@ -11,6 +11,10 @@ namespace TetrisAI {
 
 	class GameState {
 
+	public:
+		/// <summary>Largest number of polyominos that can be known in advance</summary>
+		const static int maxQueueSize = 8;
+
 	private:
 		/// <summary>Polyomino that was played to produce that state</summary>
 		const Polyomino* playedPolyomino;
@@ -20,29 +24,46 @@ namespace TetrisAI {
 		MoveResult moveResult;
 		/// <summary>Grid after the landing of the Polyomino</summary>
 		Grid grid;
-		/// <summary>Queue of known polyominos</summary>
-		std::deque<Polyomino*> polyominoQueue;
+		/// <summary>Queue of known polyominos stored inline by id (the head being at index 0) so that copying a state does not allocate</summary>
+		std::array<PolyominoId, maxQueueSize> polyominoQueue;
+		std::uint8_t polyominoQueueSize;
+
+		void popPolyominoQueueHead();
 
 	public:
-		GameState(short width, short height);
+		GameState(short width, short height, Grid::Layout layout = Grid::Layout::RowMajor);
 		GameState(GameState const & original);
+		GameState& operator=(GameState const & original) = default;
 
-		const std::vector<unsigned int>& getGridContent() const;
+		std::vector<Row> getGridContent() const;
 		const Grid& getGrid() const;
 		const MoveResult& getMoveResult() const;
 		const Polyomino* getPlayedPolyomino() const;
 		const Transformation& getPolyominoMove() const;
 		bool isGameOver() const;
 
-		void addPolyominoToQueue(Polyomino* polyomino);
+		/// <summary>Returns a 64-bit hash identifying the position: the grid and the queue of known polyominos (not the move that led to it)</summary>
+		std::uint64_t getHash() const;
+
+		/// <summary>Adds a polyomino at the end of the queue of known polyominos</summary>
+		/// <exception cred="std::invalid_argument">Thrown if the queue already holds maxQueueSize polyominos</exception>
+		void addPolyominoToQueue(const Polyomino* polyomino);
+		void addPolyominoToQueue(PolyominoId polyomino);
 		int getPolyominoQueueSize() const;
-		Polyomino* polyominoQueueHead() const;
-		Polyomino* polyominoQueueTail() const;
+		/// <summary>Returns the next polyomino to be played (nullptr if the queue is empty), taken from the catalog</summary>
+		const Polyomino* polyominoQueueHead() const;
+		/// <summary>Returns the last polyomino added to the queue (nullptr if the queue is empty), taken from the catalog</summary>
+		const Polyomino* polyominoQueueTail() const;
 
 		/// <summary>Fit the transformed polyomino in the grid and update all status accordingly</summary>
 		/// <param name="transformation">Transformation to be applied before playing the Polyomino</param>
 		/// <returns>True if the move could be played, False if it resulted in a game over</returns>
 		bool play(Transformation transformation);
+
+		/// <summary>Fit the polyomino in the grid according to a placement computed on the current grid and update all status accordingly</summary>
+		/// <param name="placement">Placement computed by Grid::computePlacements for the polyomino at the head of the queue</param>
+		/// <returns>True if the move could be played, False if it resulted in a game over</returns>
+		bool play(const Placement& placement);
 	};
 
 }
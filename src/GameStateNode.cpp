@@ -1,24 +1,51 @@
 #include "GameStateNode.h"
 #include "PolyominoNode.h"
+#include "TranspositionTable.h"
+#include "NodePool.h"
+#include <algorithm>
+#include <iterator>
 #include <stdexcept>
-#include <thread>
-#include "Utilities.h"
+#include "ThreadPool.h"
+#include "MemoryBudget.h"
+#include "ChanceSampling.h"
+#include "LazyExpansion.h"
 
 namespace TetrisAI {
 
-	GameStateNode::GameStateNode(const GameState& gameState, int depth, std::vector<Polyomino>& possiblePolyominos, Heuristic& heuristic) : gameState(gameState) 
+	GameStateNode::GameStateNode(const GameState& gameState, int depth, std::vector<Polyomino>& possiblePolyominos, Heuristic& heuristic) :
+		GameStateNode(gameState, depth, SearchContext(possiblePolyominos, heuristic))
+	{
+	}
+
+	GameStateNode::GameStateNode(const GameState& gameState, int depth, const SearchContext& context, bool useMultithreading) : gameState(gameState)
 	{ 
 		// We first build the children (which will trigger their own evaluation)
-		buildChildren(depth, possiblePolyominos, heuristic); 
+		buildChildren(depth, context, useMultithreading);
 		// Then we compute the evaluation of the node
-		updateNodeEvaluation(heuristic);
+		updateNodeEvaluation(depth, context);
+	}
+
+	GameStateNode::GameStateNode(const GameState& gameState, float childrenEvaluation, Heuristic& heuristic) : gameState(gameState)
+	{
+		nodeEvaluation = heuristic.evaluateBranch(gameState, childrenEvaluation);
+	}
+
+	void* GameStateNode::operator new(std::size_t size)
+	{
+		return NodePool<GameStateNode>::allocate(size);
+	}
+
+	void GameStateNode::operator delete(void* block, std::size_t size)
+	{
+		NodePool<GameStateNode>::deallocate(block, size);
 	}
 
-	void GameStateNode::buildChildren(int depth, std::vector<Polyomino>& possiblePolyominos, Heuristic& heuristic)
+	void GameStateNode::buildChildren(int depth, const SearchContext& context, bool useMultithreading)
 	{
 		// If it a game over, we can't build anything from there
 		// If depth is 0, we don't have anything to build, just to evaluate the current state
-		if (depth <= 0 || gameState.isGameOver())
+		// If the building was cancelled, the node stays a leaf: its children are built if the tree is updated from it
+		if (depth <= 0 || gameState.isGameOver() || context.isCancelled())
 		{
 			return;
 		}
@@ -30,41 +57,90 @@ namespace TetrisAI {
 		}
 
 		GameState newBaseGameState = gameState; // Copy game state
-		Polyomino* comingPolyomino(newBaseGameState.polyominoQueueHead()); // Retrieve next polyomino
+		const Polyomino* comingPolyomino(newBaseGameState.polyominoQueueHead()); // Retrieve next polyomino
 		// If the queue was empty, we don't know what's next
 		if (comingPolyomino == nullptr)
 		{
-			// We consider every possible polyomino and create a subtree for each one of them
-			children.reserve(possiblePolyominos.size());
-			for (auto& p : possiblePolyominos)
+			if (context.chanceSampling != nullptr)
+			{
+				// Only a sample of the possible polyominos is considered, each subtree standing for its share of them in the mean
+				std::vector<ChanceSampling::Sample> samples;
+				context.chanceSampling->choose(gameState.getHash(), context.possiblePolyominos.size(), samples);
+				children.resize(samples.size());
+				buildEachChild(depth, context, useMultithreading, [&](unsigned i) {
+					children[i] = std::make_unique<PolyominoNode>(newBaseGameState, &context.possiblePolyominos[samples[i].index], depth, context, samples[i].weight,
+						useMultithreading);
+				});
+			}
+			else
 			{
-				children.push_back(std::make_unique<PolyominoNode>(newBaseGameState, &p, depth, possiblePolyominos, heuristic));
+				// We consider every possible polyomino and create a subtree for each one of them
+				children.resize(context.possiblePolyominos.size());
+				buildEachChild(depth, context, useMultithreading, [&](unsigned i) {
+					children[i] = std::make_unique<PolyominoNode>(newBaseGameState, &context.possiblePolyominos[i], depth, context, 1, useMultithreading);
+				});
 			}
 		}
 		else
 		{
-			// If not, we know what polyomino we have to consider
-			Transformation t;
-			int gridWidth(newBaseGameState.getGrid().getWidth());
-			// Test each possible move for the given polyomino and keep the one that has the best evaluation
-			for (t.rotation = 0; t.rotation < comingPolyomino->getRotationCount(); t.rotation++)
+			// If not, we know what polyomino we have to consider: all its moves are computed at once on the current grid
+			std::vector<Placement> placements(newBaseGameState.getGrid().computePlacements(*comingPolyomino));
+			// Only the most promising moves get a subtree (children of a node of depth 1 are leaves: evaluating them is all there is to do)
+			if (context.lazyExpansion != nullptr && depth > 1)
 			{
-				int rotatedPolyominoWidth(comingPolyomino->getRotatedPiece(t.rotation).getWidth());
-				for (t.translation = 0; t.translation <= gridWidth - rotatedPolyominoWidth; t.translation++)
-				{
-					// Create a new game state where that move was played
-					GameState postMoveState = newBaseGameState;
-					postMoveState.play(t);
+				context.lazyExpansion->selectMoves(newBaseGameState, placements, context.heuristic);
+			}
+			children.resize(placements.size());
+			buildEachChild(depth, context, useMultithreading, [&](unsigned i) {
+				// Create a new game state where that move was played
+				GameState postMoveState = newBaseGameState;
+				postMoveState.play(placements[i]);
 
-					children.push_back(std::make_unique<GameStateNode>(postMoveState, depth - 1, possiblePolyominos, heuristic));
+				// If the subtree of that position was already evaluated elsewhere, its evaluation is reused instead of building it
+				float childrenEvaluation;
+				// (positions whose next polyomino is unknown are not shared: the sub roots of their PolyominoNodes are, see updateNodeEvaluation)
+				if (context.transpositionTable != nullptr && depth > 1 && !postMoveState.isGameOver() && postMoveState.getPolyominoQueueSize() > 0 &&
+					context.transpositionTable->probe(postMoveState.getHash(), depth - 1, childrenEvaluation))
+				{
+					children[i] = std::make_unique<GameStateNode>(postMoveState, childrenEvaluation, context.heuristic);
+				}
+				else
+				{
+					children[i] = std::make_unique<GameStateNode>(postMoveState, depth - 1, context, useMultithreading);
 				}
+			});
+		}
+	}
+
+	void GameStateNode::buildEachChild(int depth, const SearchContext& context, bool useMultithreading, const std::function<void(unsigned)>& buildChild)
+	{
+		// Children of a node of depth 1 are leaves that are only evaluated: they are not worth a task
+		if (useMultithreading && context.threadPool != nullptr && depth > 1)
+		{
+			// Each child is built by a task and, since it is given the same context, builds its own children as tasks as well
+			ThreadPool::TaskGroup subTrees(*context.threadPool);
+			for (unsigned i = 0; i < children.size(); i++)
+			{
+				subTrees.run([&buildChild, i]() {
+					buildChild(i);
+				});
+			}
+			subTrees.wait();
+		}
+		else
+		{
+			for (unsigned i = 0; i < children.size(); i++)
+			{
+				buildChild(i);
 			}
 		}
 	}
 
-	void GameStateNode::updateTree(Polyomino* newPolyomino, int depth, std::vector<Polyomino>& possiblePolyominos, Heuristic& heuristic, bool useMultithreading)
+	void GameStateNode::updateTree(const Polyomino* newPolyomino, int depth, const SearchContext& context, bool useMultithreading)
 	{
-		if (depth <= 0)
+		// A cancelled update leaves the subtree as it was, the next update going through it anyway
+		// (a polyomino being added is still added to every node, so that the queues stay consistent)
+		if (depth <= 0 || (newPolyomino == nullptr && context.isCancelled()))
 		{
 			return;
 		}
@@ -75,64 +151,73 @@ namespace TetrisAI {
 			gameState.addPolyominoToQueue(newPolyomino);
 		}
 
+		// If the next polyomino was unknown before and is known now
+		if (!children.empty() && queueSizeBeforeUpdate == 0 && newPolyomino != nullptr)
+		{
+			// A sampled layer may not have expanded the polyomino drawn: its children are then built for it below
+			if (!trimBranches(newPolyomino, context) && context.chanceSampling == nullptr)
+			{
+				throw std::runtime_error("Error:  could not find a match for a certain polyomino in the tree decision. Tree state unexpected. This layer should be composed of PolyominoNodes with one for each possible polyomino.");
+			}
+			newPolyomino = nullptr; // Polyomino has been "used" at this level of depth
+		}
+
 		if (children.empty())
 		{
-			// If the node has no children, we simply have to build them
-			buildChildren(depth, possiblePolyominos, heuristic);
+			// If the node has no children (a leaf, a node whose children evaluation came from the transposition table or a collapsed one), we simply have to build them
+			buildChildren(depth, context, useMultithreading);
 		}
 		else
 		{
-			// If the next polyomino was unknown before and is known now
-			if (queueSizeBeforeUpdate == 0 && newPolyomino != nullptr)
+			// Only the most promising moves are expanded further (children of a node of depth 1 are leaves that are only evaluated)
+			if (context.lazyExpansion != nullptr && depth > 1 && gameState.getPolyominoQueueSize() > 0)
 			{
-				if (!trimBranches(newPolyomino))
+				std::vector<std::unique_ptr<DecisionTreeNode>> dropped;
+				context.lazyExpansion->selectChildren(children, dropped);
+				if (context.discardedNodes != nullptr)
 				{
-					throw std::runtime_error("Error:  could not find a match for a certain polyomino in the tree decision. Tree state unexpected. This layer should be composed of PolyominoNodes with one for each possible polyomino.");
+					for (auto& child : dropped)
+					{
+						context.discardedNodes->add(std::move(child));
+					}
 				}
-				newPolyomino = nullptr; // Polyomino has been "used" at this level of depth
 			}
 
 			// For the next step, we recursively call updateTree on the children of this node
-			if (useMultithreading)
-			{
-				std::vector<int> splitRangesBounds(splitRange(0, children.size(), std::thread::hardware_concurrency()));
-				
-				// Split up the work between a number of sub threads
-				std::vector<std::thread> subThreads;
-				subThreads.reserve(splitRangesBounds.size() - 1);
-				for (unsigned i = 0; i < splitRangesBounds.size() - 1; i++)
-				{
-					subThreads.push_back(std::thread(&GameStateNode::updateSubTree, this,
-						splitRangesBounds[i], splitRangesBounds[i+1] - 1,
-						newPolyomino, depth, std::ref(possiblePolyominos), std::ref(heuristic)
-					));
-				}
-
-				// Wait for each thread to finish
-				for (auto& t : subThreads)
+			if (useMultithreading && context.threadPool != nullptr && depth > 1)
+			{
+				// Each child subtree is a task, whose own children become tasks as well: idle threads of the pool steal the largest subtrees left
+				ThreadPool::TaskGroup subTrees(*context.threadPool);
+				for (unsigned i = 0; i < children.size(); i++)
 				{
-					t.join();
+					subTrees.run([this, i, newPolyomino, depth, &context]() {
+						updateSubTree(i, i, newPolyomino, depth, context, true);
+					});
 				}
+				subTrees.wait();
 			}
 			else
 			{
-				updateSubTree(0, children.size() - 1, newPolyomino, depth, possiblePolyominos, heuristic);
+				updateSubTree(0, children.size() - 1, newPolyomino, depth, context, false);
 			}
 		}
 
 		// Finally, we update the node evaluation since its children have been updated as well
-		updateNodeEvaluation(heuristic);
+		updateNodeEvaluation(depth, context);
 	}
 
-	void GameStateNode::updateSubTree(unsigned from, unsigned to, Polyomino* newPolyomino, int depth, std::vector<Polyomino>& possiblePolyominos, Heuristic& heuristic)
+	void GameStateNode::updateSubTree(unsigned from, unsigned to, const Polyomino* newPolyomino, int depth, const SearchContext& context, bool useMultithreading)
 	{
+		// As in buildChildren, PolyominoNodes (children of a node whose next polyomino is unknown) consider the same move as their parent
+		// and thus the same depth, while the children reached by playing a move consider one move less
+		int childrenDepth(gameState.getPolyominoQueueSize() == 0 ? depth : depth - 1);
 		for (unsigned i = from; i <= to; i++)
 		{
-			children[i]->updateTree(newPolyomino, depth - 1, possiblePolyominos, heuristic, false);
+			children[i]->updateTree(newPolyomino, childrenDepth, context, useMultithreading);
 		}
 	}
 
-	bool GameStateNode::trimBranches(Polyomino* matchingPolyomino)
+	bool GameStateNode::trimBranches(const Polyomino* matchingPolyomino, const SearchContext& context)
 	{
 		// Search among children for a PolyominoNode that considered the case where "matchingPolyomino" is played
 		std::unique_ptr<DecisionTreeNode> matchingChild(nullptr);
@@ -142,6 +227,10 @@ namespace TetrisAI {
 			{
 				matchingChild = std::move(children.back());
 			}
+			else if (context.discardedNodes != nullptr)
+			{
+				context.discardedNodes->add(std::move(children.back()));
+			}
 			children.pop_back();
 		}
 
@@ -151,40 +240,97 @@ namespace TetrisAI {
 		}
 
 		// We then replace this node's children by the children of the PolyominoNode that matched
+		if (context.discardedNodes != nullptr)
+		{
+			for (auto& child : children)
+			{
+				context.discardedNodes->add(std::move(child));
+			}
+		}
 		children.clear();
 		matchingChild->movingChildrenOwnership(children);
 		return true;
 	}
 
-	void GameStateNode::updateNodeEvaluation(Heuristic& heuristic)
+	void GameStateNode::updateNodeEvaluation(int depth, const SearchContext& context)
 	{
 		if (children.empty())
 		{
-			nodeEvaluation = heuristic.evaluate(gameState);
+			nodeEvaluation = context.heuristic.evaluate(gameState);
 		}
 		else
 		{
 			// Update the evaluation of the node based on its children
 			float childrenEvaluation(0); // Initialize the evaluation of the node
-			int childNodePosition(0);
+			float siblingsWeight(0);
 			for (auto& child : children)
 			{
-				childrenEvaluation = child->computeSiblingsEvaluation(childrenEvaluation, childNodePosition);
-				childNodePosition++;
+				childrenEvaluation = child->computeSiblingsEvaluation(childrenEvaluation, siblingsWeight);
+				siblingsWeight += child->getSiblingWeight();
+			}
+			nodeEvaluation = context.heuristic.evaluateBranch(gameState, childrenEvaluation);
+
+			// The children evaluation only depends on the grid, the queue and the depth: other nodes reaching the same position can reuse it
+			// (unless the building was cancelled, some subtrees then being shallower than the depth)
+			// When the next polyomino is unknown, the sub roots of the PolyominoNodes are copies of this node, whose branch evaluation depends
+			// on the move that led to it (e.g. the bonus of the lines it cleared), which the hash does not account for: only the sub roots,
+			// whose children evaluation does not depend on that move, are shared
+			if (context.transpositionTable != nullptr && !context.isCancelled() && gameState.getPolyominoQueueSize() > 0)
+			{
+				context.transpositionTable->store(gameState.getHash(), depth, childrenEvaluation);
+			}
+
+			// The children are evaluated: their subtrees are no longer needed for this decision
+			if (context.memoryBudget != nullptr && context.memoryBudget->isExceeded())
+			{
+				collapseChildren(context);
 			}
-			nodeEvaluation = heuristic.evaluateBranch(gameState, childrenEvaluation);
 		}
 	}
 
-	void GameStateNode::movingChildrenOwnership(std::vector<std::unique_ptr<DecisionTreeNode>>& destination)
+	void GameStateNode::collapseChildren(const SearchContext& context)
 	{
-		while (!children.empty())
+		// The lowest evaluated moves are the least likely to be played, thus to need their subtree again (ties keep the order of the children)
+		std::vector<unsigned> order(children.size());
+		for (unsigned i = 0; i < order.size(); i++)
 		{
-			destination.push_back(std::move(children.back()));
-			children.pop_back();
+			order[i] = i;
+		}
+		std::stable_sort(order.begin(), order.end(), [this](unsigned a, unsigned b) {
+			return children[a]->getNodeEvaluation() < children[b]->getNodeEvaluation();
+		});
+
+		for (unsigned i = 0; i < order.size(); i++)
+		{
+			if (children[order[i]]->collapse())
+			{
+				context.memoryBudget->recordCollapse();
+				if (!context.memoryBudget->isExceeded())
+				{
+					return;
+				}
+			}
 		}
 	}
 
+	bool GameStateNode::collapse()
+	{
+		if (children.empty())
+		{
+			return false;
+		}
+		children.clear();
+		children.shrink_to_fit();
+		return true;
+	}
+
+	void GameStateNode::movingChildrenOwnership(std::vector<std::unique_ptr<DecisionTreeNode>>& destination)
+	{
+		// The children keep their order, so that ties between moves are broken as in a tree built from scratch
+		destination.insert(destination.end(), std::make_move_iterator(children.begin()), std::make_move_iterator(children.end()));
+		children.clear();
+	}
+
 	std::unique_ptr<DecisionTreeNode> GameStateNode::extractBestChild()
 	{
 		if (children.empty())
@@ -207,7 +353,7 @@ namespace TetrisAI {
 		return std::move(children[bestIndex]);
 	}
 
-	bool GameStateNode::matchPolyomino(Polyomino* polyomino)
+	bool GameStateNode::matchPolyomino(const Polyomino* polyomino)
 	{
 		return false;
 	}
@@ -241,14 +387,19 @@ namespace TetrisAI {
 		return output;
 	}
 
-	float GameStateNode::computeSiblingsEvaluation(float currentEvaluation, unsigned nodePosition)
+	float GameStateNode::computeSiblingsEvaluation(float currentEvaluation, float siblingsWeight)
 	{
 		// If this node is the first of the list, we simply return the evaluation of the node, 
 		// if not we compare it with the current evaluation of the parent and replace it only if we have a better one
-		if (nodePosition > 0 && currentEvaluation > getNodeEvaluation())
+		if (siblingsWeight > 0 && currentEvaluation > getNodeEvaluation())
 		{
 			return currentEvaluation;
 		}
 		return getNodeEvaluation();
 	}
+
+	float GameStateNode::getSiblingWeight() const
+	{
+		return 1;
+	}
 }
\ No newline at end of file
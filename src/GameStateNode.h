@@ -3,22 +3,44 @@
 
 #include "DecisionTreeNode.h"
 #include "GameState.h"
+#include <functional>
 
 namespace TetrisAI {
 
 	class GameStateNode : public DecisionTreeNode {
 
 	public:
+		using DecisionTreeNode::updateTree;
+
 		GameStateNode(const GameState& gameState, int depth, std::vector<Polyomino>& possiblePolyominos, Heuristic& heuristic);
-		virtual void updateTree(Polyomino* newPolyomino, int depth, std::vector<Polyomino>& possiblePolyominos, Heuristic& heuristic, bool useMultithreading);
+		/// <summary>Builds the node along with its subtree</summary>
+		/// <param name="gameState">Game state of the node</param>
+		/// <param name="depth">Number of moves considered from this node</param>
+		/// <param name="context">Context of the search</param>
+		/// <param name="useMultithreading">Whether the subtrees of the children are built by the threads of the thread pool of the context (as in updateTree)</param>
+		GameStateNode(const GameState& gameState, int depth, const SearchContext& context, bool useMultithreading = false);
+
+		/// <summary>Builds a node whose children evaluation is already known (e.g. found in a transposition table): its children are only built if the tree is updated from it</summary>
+		/// <param name="gameState">Game state of the node</param>
+		/// <param name="childrenEvaluation">Evaluation of the children the node would have</param>
+		/// <param name="heuristic">Heuristic used to evaluate the node from its children evaluation</param>
+		GameStateNode(const GameState& gameState, float childrenEvaluation, Heuristic& heuristic);
+
+		/// <summary>Nodes are allocated from a NodePool: building and discarding branches does not go through the global heap</summary>
+		static void* operator new(std::size_t size);
+		static void operator delete(void* block, std::size_t size);
+
+		virtual void updateTree(const Polyomino* newPolyomino, int depth, const SearchContext& context, bool useMultithreading);
 		virtual void movingChildrenOwnership(std::vector<std::unique_ptr<DecisionTreeNode>>& destination);
+		virtual bool collapse();
 		virtual std::unique_ptr<DecisionTreeNode> extractBestChild();
-		virtual bool matchPolyomino(Polyomino* polyomino);
+		virtual bool matchPolyomino(const Polyomino* polyomino);
 		virtual NodeStatus getNodeStatus();
 		virtual float getNodeEvaluation() const;
 		virtual Transformation getPolyominoMove() const;
 		virtual bool isGameOver() const;
-		virtual float computeSiblingsEvaluation(float currentEvaluation, unsigned nodePosition);
+		virtual float computeSiblingsEvaluation(float currentEvaluation, float siblingsWeight);
+		virtual float getSiblingWeight() const;
 
 	private:
 		float nodeEvaluation;
@@ -26,21 +48,36 @@ namespace TetrisAI {
 		/// <summary>Holds an homogeneous collection (by construction) of concrete DecisionTreeNodes</summary>
 		std::vector<std::unique_ptr<DecisionTreeNode>> children;
 
-		void buildChildren(int depth, std::vector<Polyomino>& possiblePolyominos, Heuristic& heuristic);
-		void updateNodeEvaluation(Heuristic& heuristic);
+		/// <summary>Builds the children of the node along with their subtrees</summary>
+		/// <param name="useMultithreading">Whether the children may be built as tasks of the thread pool of the context</param>
+		void buildChildren(int depth, const SearchContext& context, bool useMultithreading);
+
+		/// <summary>Calls buildChild for the index of every slot of children, as tasks of the thread pool of the context if allowed and worth it</summary>
+		/// <remarks>Each call fills its own slot: the children keep the order of a serial build</remarks>
+		void buildEachChild(int depth, const SearchContext& context, bool useMultithreading, const std::function<void(unsigned)>& buildChild);
+
+		/// <summary>Evaluates the node from its children (or from the heuristic if it is a leaf) and shares the children evaluation through the transposition table</summary>
+		/// <param name="depth">Number of moves considered from this node</param>
+		/// <param name="context">Context of the search</param>
+		void updateNodeEvaluation(int depth, const SearchContext& context);
+
+		/// <summary>Collapses the subtrees of the children, the lowest evaluated first, as long as the memory budget of the context is exceeded</summary>
+		void collapseChildren(const SearchContext& context);
 
 		/// <summary>Call updateTree on a subset of children</summary>
 		/// <param name="from">Index of the first child</param>
 		/// <param name="to">Index of the last child</param>
-		void updateSubTree(unsigned from, unsigned to, Polyomino* newPolyomino, int depth, std::vector<Polyomino>& possiblePolyominos, Heuristic& heuristic);
+		/// <param name="useMultithreading">Whether the children may run the updates of their own children as tasks of the thread pool of the context</param>
+		void updateSubTree(unsigned from, unsigned to, const Polyomino* newPolyomino, int depth, const SearchContext& context, bool useMultithreading);
 
 		/// <summary>
 		/// Find a branch among children that matches the given polyomino (i.e. a PolyominoNode that considered moves with the given polyomino)
 		/// and keep this branch only (by removing other children and retrieving the ownership of the children of the matching child)
 		/// </summary>
 		/// <param name="matchingPolyomino">Polyomino whose branch should be kept</param>
+		/// <param name="context">Context whose discarded nodes receive the other branches (if any)</param>
 		/// <returns>True if a branch matching the given polyomino could be found to perform the trimming process. False if not</returns>
-		bool trimBranches(Polyomino* matchingPolyomino);
+		bool trimBranches(const Polyomino* matchingPolyomino, const SearchContext& context);
 	};
 
 }
@@ -1,129 +1,276 @@
 #include "Grid.h"
 #include <stdexcept>
 #include <algorithm>
+#include <string>
 #include "Utilities.h"
+#include "BitKernels.h"
 
 namespace TetrisAI {
 
-	Grid::Grid(short w, short h) : width(w), topHeight(0)
+	Grid::Grid(short w, short h, Layout layout) : content(), columns(layout == Layout::RowAndColumnMajor ? w : 0), columnHeights(), layout(layout), width(w), height(h), topHeight(0),
+		rowTransitionsSum(2 * h), columnTransitionsSum(w), heightsSum(0), blocksCount(0), hash(0)
 	{
-		if (w > Grid::maxSize || h > Grid::maxSize)
+		if (w > Grid::maxWidth || h > Grid::maxHeight)
 		{
-			throw std::invalid_argument("A grid can't exceed 32 in width or 32 in height.");
+			throw std::invalid_argument("A grid can't exceed " + std::to_string(Grid::maxWidth) + " in width or " + std::to_string(Grid::maxHeight) + " in height.");
 		}
 		if (w < Grid::minSize || h < Grid::minSize)
 		{
 			throw std::invalid_argument("A grid must be at least 4 blocks wide and 4 blocks high.");
 		}
+	}
 
-		content = std::vector<unsigned int>(h);
+	Grid::ColumnWords::ColumnWords(short count) : count(count)
+	{
+		std::fill_n(words.begin(), count, 0u);
+	}
+
+	Grid::ColumnWords::ColumnWords(const ColumnWords& other) : count(other.count)
+	{
+		std::copy_n(other.words.begin(), count, words.begin());
 	}
 
-	Grid::Grid(const Grid &original)
+	Grid::ColumnWords& Grid::ColumnWords::operator=(const ColumnWords& other)
 	{
-		width = original.width;
-		content = original.content;
-		topHeight = original.topHeight;
+		count = other.count;
+		std::copy_n(other.words.begin(), count, words.begin());
+		return *this;
 	}
 
 	MoveResult Grid::fitPiece(const Polyomino & polyomino, Transformation transformation)
 	{
-		// in the following, piece.size() represents the height of the piece as a PolyominoState is guaranteed to have all its rows non empty
-		const std::vector<unsigned int> piece(polyomino.getTransformedPiece(transformation));
-		
-		if (!isPieceTranslationValid(piece))
+		return fitPiece(polyomino, polyomino.getPlacedPieceIndex(transformation));
+	}
+
+	MoveResult Grid::fitPiece(const Polyomino & polyomino, int placedPieceIndex)
+	{
+		if (placedPieceIndex < 0 || placedPieceIndex >= polyomino.getPlacedPiecesCount() || !isPieceTranslationValid(polyomino.getPlacedPiece(placedPieceIndex)))
 		{
 			throw std::invalid_argument("The piece translation makes it fall out of the grid");
 		}
-		
-		MoveResult result;
-		result.landingRow = findFittingRow(piece);
+
+		const PlacedPiece& piece(polyomino.getPlacedPiece(placedPieceIndex));
+		int landingRow(findFittingRow(piece));
 
 		// Could not integrate the piece in the grid
-		if (result.landingRow == -1)
+		if (landingRow == -1)
+		{
+			return MoveResult(true, 0, 0, -1);
+		}
+
+		return mergePiece(piece, landingRow);
+	}
+
+	MoveResult Grid::fitPiece(const Polyomino & polyomino, const Placement& placement)
+	{
+		if (placement.result.gameOver)
+		{
+			return placement.result;
+		}
+
+		return mergePiece(polyomino.getPlacedPiece(placement.placedPieceIndex), placement.result.landingRow);
+	}
+
+	std::vector<Placement> Grid::computePlacements(const Polyomino& polyomino) const
+	{
+		std::vector<Placement> placements;
+		Row completeLine(getCompleteLine());
+		// Placed pieces are ordered by rotation then translation: the ones too wide for this grid are skipped
+		for (int index = 0; index < polyomino.getPlacedPiecesCount(); index++)
 		{
-			result.gameOver = true;
-			return result;
+			const PlacedPiece& piece(polyomino.getPlacedPiece(index));
+			if (!isPieceTranslationValid(piece))
+			{
+				continue;
+			}
+
+			MoveResult result;
+			result.landingRow = findFittingRow(piece);
+			result.gameOver = (result.landingRow == -1);
+
+			// A row is cleared if the piece fills all its remaining empty blocks
+			for (int h = 0; h < piece.height && !result.gameOver; h++)
+			{
+				if ((content[result.landingRow + h] | piece.rows[h]) == completeLine)
+				{
+					result.linesCleared++;
+					result.pieceVanishedBlocks += activeBitsCount(piece.rows[h]);
+				}
+			}
+
+			placements.push_back(Placement(Transformation(piece.translation, piece.rotation), index, result));
 		}
 
-		int landingTopHeight(result.landingRow + piece.size());
+		return placements;
+	}
+
+	MoveResult Grid::mergePiece(const PlacedPiece& piece, int landingRow)
+	{
+		MoveResult result;
+		result.landingRow = landingRow;
+
+		int landingTopHeight(result.landingRow + piece.height);
+		// Only the rows between the landing row and the current top can change (rows above the cleared lines are shifted down)
+		// Their contribution to the cached features is removed now and added back once the piece is merged
+		int changedRowsEnd(std::max(landingTopHeight, (int)topHeight));
+		rowTransitionsSum -= BitKernels::get().rowTransitions(content.data() + result.landingRow, changedRowsEnd - result.landingRow, getWidth());
+		columnTransitionsSum -= columnTransitionsBetween(result.landingRow, changedRowsEnd);
+		hash ^= rowsHash(result.landingRow, changedRowsEnd);
+
 		// If it is ok: we merge the piece and the grid and clear the complete lines along the way
 		topHeight = (landingTopHeight > topHeight) ? landingTopHeight : topHeight;
 
-		// Browse the rows of the grid that must change and clear complete lines if needed
-		for (unsigned h = 0; h < piece.size(); h++)
+		// The piece lands on top of the columns it covers: their new height is given by the top of the piece
+		for (int col = 0; col < piece.width; col++)
 		{
-			int currentRow = result.landingRow + h - result.linesCleared;
-			content[currentRow] = piece[h] | content[currentRow];
+			short newHeight(result.landingRow + piece.topProfile[col] + 1);
+			heightsSum += newHeight - columnHeights[piece.translation + col];
+			columnHeights[piece.translation + col] = newHeight;
+		}
+
+		// Browse the rows of the grid that must change and mark the complete lines
+		unsigned int fullRows(0);
+		for (int h = 0; h < piece.height; h++)
+		{
+			Row pieceRow(piece.rows[h]);
+			int currentRow = result.landingRow + h;
+			content[currentRow] = pieceRow | content[currentRow];
+			blocksCount += activeBitsCount(pieceRow);
+			if (layout == Layout::RowAndColumnMajor)
+			{
+				Row blocks(pieceRow);
+				for (int col = 0; blocks; blocks >>= 1, col++)
+				{
+					columns[col] |= (unsigned int)(blocks & 1) << currentRow;
+				}
+			}
 
 			if (content[currentRow] == getCompleteLine())
 			{
-				result.pieceVanishedBlocks += activeBitsCount(piece[h]);
-				removeRow(currentRow);
+				result.pieceVanishedBlocks += activeBitsCount(pieceRow);
 				result.linesCleared++;
-				topHeight--;
+				fullRows |= 1u << currentRow;
 			}
 		}
 
-		return result;
-	}
+		// All complete lines are cleared at once
+		if (fullRows)
+		{
+			removeRows(fullRows);
+			topHeight -= result.linesCleared;
+			blocksCount -= result.linesCleared * getWidth();
+		}
 
-	
-	int Grid::findFittingRow(const std::vector<unsigned int>& piece) const
-	{
-		int landingRow(topHeight);
-		// If the grid is not empty, we go down until there is a collision
-		if (landingRow != 0)
+		if (result.linesCleared > 0)
 		{
-			int collisionSum(0);
-			while (collisionSum == 0 && landingRow > 0)
+			// Every column may have lost height
+			heightsSum = 0;
+			for (int col = 0; col < getWidth(); col++)
 			{
-				landingRow--;
-				short rangeTop = std::min(getHeight(), landingRow + (int)piece.size());
-				for (int h = landingRow; h < rangeTop; h++)
+				if (layout == Layout::RowAndColumnMajor)
 				{
-					collisionSum += piece[h - landingRow] & content[h];
+					columnHeights[col] = bitLength(columns[col]);
 				}
+				heightsSum += columnHeights[col];
 			}
-
-			// If we stopped due to a collision, we have to go one step up (the last height with no collision)
-			landingRow = (collisionSum == 0) ? landingRow : landingRow + 1;
 		}
 
-		// THEN: we check if it's a game over situation, if it is we return -1, else we return the lowest row where the piece would fit
-		return (landingRow + (int)(piece.size()) > getHeight()) ? -1 : landingRow;
+		rowTransitionsSum += BitKernels::get().rowTransitions(content.data() + result.landingRow, changedRowsEnd - result.landingRow, getWidth());
+		columnTransitionsSum += columnTransitionsBetween(result.landingRow, changedRowsEnd);
+		hash ^= rowsHash(result.landingRow, changedRowsEnd);
+
+		return result;
 	}
 
-	bool Grid::isPieceTranslationValid(const std::vector<unsigned int>& piece) const
+	int Grid::findFittingRow(const PlacedPiece& piece) const
 	{
-		unsigned int maxValue(getCompleteLine()); // highest possible bit considering the width of the grid
-		for (auto& rowValue : piece)
+		// The piece falls until one of its columns touches the top of the corresponding grid column
+		int landingRow(0);
+		for (int col = 0; col < piece.width; col++)
 		{
-			if (rowValue > maxValue)
-			{
-				return false;
-			}
+			landingRow = std::max(landingRow, columnHeights[piece.translation + col] - piece.bottomProfile[col]);
 		}
-		return true;
+
+		// THEN: we check if it's a game over situation, if it is we return -1, else we return the lowest row where the piece would fit
+		return (landingRow + piece.height > getHeight()) ? -1 : landingRow;
+	}
+
+	bool Grid::isPieceTranslationValid(const PlacedPiece& piece) const
+	{
+		return piece.translation + piece.width <= getWidth();
+	}
+
+	std::vector<Row> Grid::getContent() const
+	{
+		return std::vector<Row>(content.begin(), content.begin() + height);
 	}
 
-	const std::vector<unsigned int>& Grid::getContent() const
+	Row Grid::getRow(int row) const
 	{
-		return content;
+		return content[row];
 	}
 
-	unsigned int Grid::getCompleteLine() const
+	Row Grid::getCompleteLine() const
 	{
-		return (1 << getWidth()) - 1;
+		return fullRow(getWidth());
 	}
 
-	void Grid::removeRow(unsigned int row)
+	void Grid::removeRows(unsigned int fullRows)
 	{
-		for (int index = row; index < getHeight() - 1; index++)
+		// Single compaction pass: each remaining row is moved down by the number of removed rows below it
+		int removed(0);
+		for (int row = bitLength(fullRows & (~fullRows + 1)) - 1; row < getTopHeight(); row++)
 		{
-			content[index] = content[index + 1];
+			if ((fullRows >> row) & 1)
+			{
+				removed++;
+			}
+			else
+			{
+				content[row - removed] = content[row];
+			}
+		}
+		for (int row = getTopHeight() - removed; row < getTopHeight(); row++)
+		{
+			content[row] = 0;
+		}
+
+		if (layout == Layout::RowAndColumnMajor)
+		{
+			// Remove the bits of the rows from every column (heights are read from the columns once the whole piece has been merged)
+			BitKernels::get().compactColumns(columns.data(), getWidth(), ~fullRows);
+			return;
+		}
+
+		// The removed rows were full: columns going above them simply lose one block of height per removed row below their top
+		// while columns whose top block was in a removed row must look for their new top block below it
+		Row lostTopMask(0);
+		for (int col = 0; col < getWidth(); col++)
+		{
+			int columnHeight(columnHeights[col]);
+			if (columnHeight > 0 && ((fullRows >> (columnHeight - 1)) & 1))
+			{
+				lostTopMask |= Row(1) << col;
+				columnHeights[col] = 0;
+			}
+			else
+			{
+				columnHeights[col] -= activeBitsCount(fullRows & (columnHeight ? ~0u >> (32 - columnHeight) : 0));
+			}
+		}
+
+		for (int index = getTopHeight() - removed - 1; index >= 0 && lostTopMask; index--)
+		{
+			Row foundTops(content[index] & lostTopMask);
+			for (int col = 0; foundTops; col++, foundTops >>= 1)
+			{
+				if (foundTops & 1)
+				{
+					columnHeights[col] = index + 1;
+				}
+			}
+			lostTopMask &= ~content[index];
 		}
-		content[getHeight() - 1] = 0;
 	}
 
 	int Grid::getWidth() const
@@ -133,7 +280,12 @@ namespace TetrisAI {
 
 	int Grid::getHeight() const
 	{
-		return content.size();
+		return height;
+	}
+
+	Grid::Layout Grid::getLayout() const
+	{
+		return layout;
 	}
 
 	int Grid::getTopHeight() const
@@ -141,111 +293,103 @@ namespace TetrisAI {
 		return topHeight;
 	}
 
-	int Grid::columnTransitions() const
+	std::uint64_t Grid::getHash() const
 	{
-		int output(0);
+		return hash;
+	}
 
-		// Transition at the upper and lower boundaries of the non-empty grid
-		if(topHeight > 0) 
-		{
-			output += activeBitsCount(content[getTopHeight() - 1] ^ 0); // Upper boundary of the grid
-		}
-		output += activeBitsCount(getCompleteLine() ^ content[0]); // Lower boundary of the grid
+	std::uint64_t Grid::rowHash(Row value, int row)
+	{
+		// One random key per row index, drawn once from a fixed seed so that hashes are the same from one run to another
+		static const std::array<std::uint64_t, maxHeight> rowKeys([]() {
+			std::array<std::uint64_t, maxHeight> keys;
+			for (int index = 0; index < maxHeight; index++)
+			{
+				keys[index] = hashMix(0x9E3779B97F4A7C15ull * (index + 1));
+			}
+			return keys;
+		}());
+
+		return value ? hashMix(std::uint64_t(value) ^ rowKeys[row]) : 0;
+	}
 
-		// Transition inside the grid
-		for (int row = 0; row < getTopHeight() - 1; row++)
+	std::uint64_t Grid::rowsHash(int firstRow, int endRow) const
+	{
+		std::uint64_t output(0);
+		for (int row = firstRow; row < endRow; row++)
 		{
-			output += activeBitsCount(content[row] ^ content[row + 1]);
+			output ^= rowHash(content[row], row);
 		}
-
 		return output;
 	}
 
-	int Grid::rowTransitions() const
+	int Grid::getColumnHeight(int col) const
 	{
-		int output(0), gridWidth(getWidth());
-
-		unsigned int highestOrderBit(1 << (gridWidth - 1));
+		return columnHeights[col];
+	}
 
-		for (int row = 0; row < getTopHeight(); row++)
-		{
-			// Transitions at the boundaries of the grid
-			if (!(content[row] & highestOrderBit)) { output++; } // Left boundary of the grid (add 1 if the most left bit is 0)
-			if (!(content[row] & 1)) { output++; } // Right boundary of the grid (add 1 if the most right bit is 0)
+	int Grid::getBlocksCount() const
+	{
+		return blocksCount;
+	}
 
-			// Transitions inside the grid
-			for (int col = 0; col < gridWidth - 1; col++)
-			{
-				output += ((content[row] >> col) & 1) ^ ((content[row] >> (col + 1)) & 1);
-			}
-		}
+	int Grid::columnTransitions() const
+	{
+		return columnTransitionsSum;
+	}
 
-		return output;
+	int Grid::rowTransitions() const
+	{
+		// Rows above the top height are not considered: each of them was counted in the sum with its two empty border blocks
+		return rowTransitionsSum - 2 * (getHeight() - getTopHeight());
 	}
 
 	int Grid::cellars() const
 	{
-		int output(0), roofMask(0);
-		unsigned int completeLine(getCompleteLine());
+		// Every block of a column below its height is either full or a hole:
+		// the number of holes is the sum of the columns heights minus the number of full blocks
+		return heightsSum - blocksCount;
+	}
 
-		for (int row = getTopHeight() - 1; row >= 0; row--)
+	int Grid::columnTransitionsBetween(int firstRow, int endRow) const
+	{
+		// Transitions between each row of [firstRow, endRow] and the row below it, the floor being full and the space above the grid empty
+		int output(0);
+		Row below(firstRow > 0 ? content[firstRow - 1] : getCompleteLine());
+		for (int row = firstRow; row <= endRow; row++)
 		{
-			// roofMask bits which are set to 1 indicates that, in the corresponding column, in a higher position, a bit is set to 1
-			// Thus if there is a match, with completeLine - gridContent[row] that means, we found a hole
-			roofMask = roofMask & (completeLine - content[row]); // completeLine - gridContent[row] is equivalent to performing ~gridContent[row] on the first n-bytes with n=width of the grid
-			output += activeBitsCount(roofMask); // Count of the number of holes found
-			roofMask = roofMask | content[row]; // New mask is the combination of found holes and full blocks in the current row
+			Row current(row < getHeight() ? content[row] : 0);
+			output += activeBitsCount(below ^ current);
+			below = current;
 		}
-
 		return output;
 	}
 
 	int Grid::wells() const
 	{
-		// wellMask allows to filter rows to keep only the bits of 3 columns (or 2 if we are next to the borders of the grid)
-		// wellPattern indicates what should be the value of the filtering via wellMask if the pattern describing the top of a well is found
-		//
-		// Example 1.	with 3 and 2 as values, we can search for wells on the right side of the grid as it would match rows ending with 10
-		// Example 2.	with 7 and 5 as values, we can search for wells in the second column as it would match rows ending with 101
-		int output(0), wellMask(3), wellPattern(2), gridWidth(getWidth());
-
-		for (int col = 0; col < gridWidth; col++)
+		if (layout == Layout::RowAndColumnMajor)
 		{
-			for (int row = getTopHeight() - 1; row >= 0; row--)
-			{
-				// Check if the pattern is respected for the columns filtered by the mask
-				if ((content[row] & wellMask) == wellPattern)
-				{
-					output += 1 + emptyBlocksDown(row - 1, col);
-				}
-			}
-
-			// Modify the pattern and mask for the next column
-			if (col == 0)
-			{
-				// If it was the first step, we have to change the values
-				wellMask = 7;
-				wellPattern = 5;
-			}
-			else if (col == gridWidth - 2)
-			{
-				// If we reached, the end of the grid, we have to change the values
-				wellMask = (1 << (gridWidth - 1)) + (1 << (gridWidth - 2)); // e.g 512 + 256 if W=10
-				wellPattern = 1 << (gridWidth - 2); // e.g 256 if W=10
-			}
-			else
-			{
-				// If we are going from one basic case to another, we just shift values
-				wellMask <<= 1;
-				wellPattern <<= 1;
-			}
+			return BitKernels::get().columnWells(columns.data(), getWidth(), getTopHeight());
 		}
 
-		return output;
+		return BitKernels::get().wells(content.data(), getTopHeight(), getWidth());
 	}
 
 	int Grid::emptyBlocksDown(int row, int col) const
 	{
+		// Above the column height, every block is empty down to the top block of the column
+		if (row >= columnHeights[col])
+		{
+			return row + 1 - columnHeights[col];
+		}
+
+		if (layout == Layout::RowAndColumnMajor)
+		{
+			// Distance between the row and the highest full block below or at that row
+			unsigned int blocksBelow(row < 0 ? 0 : columns[col] & (~0u >> (31 - row)));
+			return row + 1 - bitLength(blocksBelow);
+		}
+
 		int output(0);
 		// While we have empty blocks in the column col, we keep going down
 		while (row >= 0 && !((content[row] >> col) & 1))
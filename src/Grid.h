@@ -2,19 +2,37 @@
 #define TETRISAI_GRID_H
 
 #include <vector>
+#include <array>
+#include <cstdint>
 #include "Polyomino.h"
 #include "MoveResult.h"
+#include "Placement.h"
+#include "Row.h"
 
 namespace TetrisAI {
 
 	class Grid {
 
 	public:
-		const static int maxSize = 32;
+		/// <summary>Widest grid supported: a row of the grid is stored in a single Row</summary>
+		const static int maxWidth = rowBits;
+		/// <summary>Highest grid supported: a column of the grid is stored in a 32-bit word</summary>
+		const static int maxHeight = 32;
 		const static int minSize = 4;
 
-		Grid(short w, short h);
-		Grid(const Grid &original);
+		/// <summary>Defines how the blocks of the grid are stored</summary>
+		enum class Layout {
+			/// <summary>One Row bitmask per row (bit c being the block of column c)</summary>
+			RowMajor,
+			/// <summary>One bitmask per row plus, kept in sync, one bitmask per column (bit r being the block of row r)</summary>
+			/// <remarks>Per-column features (holes, wells, empty blocks down) are then computed from the column bitmasks, which does not make the evaluations measurably faster yet</remarks>
+			RowAndColumnMajor
+		};
+
+		/// <param name="w">Width of the grid</param>
+		/// <param name="h">Height of the grid</param>
+		/// <param name="layout">Representations of the grid that should be maintained</param>
+		Grid(short w, short h, Layout layout = Layout::RowMajor);
 
 		/// <summary>Make the polyomino (rotated and translated) fall into the grid and update the grid accordingly</summary>
 		/// <param name="polyomino">Polyomino that should be added to the grid</param>
@@ -23,25 +41,59 @@ namespace TetrisAI {
 		/// <returns>Result status of the fall</returns>
 		MoveResult fitPiece(const Polyomino& polyomino, Transformation transformation);
 
+		/// <summary>Make the polyomino fall into the grid according to one of its precomputed placed pieces</summary>
+		/// <param name="polyomino">Polyomino that should be added to the grid</param>
+		/// <param name="placedPieceIndex">Index of the placed piece of the polyomino (see Polyomino::getPlacedPieceIndex)</param>
+		/// <exception cred="std::invalid_argument">Thrown if the placed piece does not exist or does not fit in the width of the grid</exception>
+		/// <returns>Result status of the fall</returns>
+		MoveResult fitPiece(const Polyomino& polyomino, int placedPieceIndex);
+
+		/// <summary>Make the polyomino fall into the grid according to a placement previously computed on this grid state</summary>
+		/// <param name="polyomino">Polyomino that should be added to the grid</param>
+		/// <param name="placement">Placement computed by computePlacements for this polyomino (the landing search is skipped)</param>
+		/// <returns>Result status of the fall</returns>
+		MoveResult fitPiece(const Polyomino& polyomino, const Placement& placement);
+
+		/// <summary>Computes, in one pass and without modifying the grid, the outcome of every legal transformation of the polyomino</summary>
+		/// <param name="polyomino">Polyomino whose moves should be computed</param>
+		/// <returns>One placement per (rotation, translation), ordered by rotation then translation</returns>
+		std::vector<Placement> computePlacements(const Polyomino& polyomino) const;
+
 		// Getters
-		const std::vector<unsigned int>& getContent() const;
+		/// <summary>Returns a copy of the rows of the grid (from the bottom row to the top one)</summary>
+		std::vector<Row> getContent() const;
+		Row getRow(int row) const;
 		int getWidth() const;
 		int getHeight() const;
+		Layout getLayout() const;
 
 		/// <summary>Returns the height of the the highest non-empty row (e.g returns 5 if row indexed at 4 is not empty and all rows above it are)</summary>
 		int getTopHeight() const;
 
+		/// <summary>Returns a 64-bit hash of the blocks of the grid, kept up to date as pieces land (equal grids have equal hashes whatever the moves that built them)</summary>
+		std::uint64_t getHash() const;
+
+		/// <summary>Returns the height of the highest block of a column (e.g. returns 3 if the block at row 2 is full and all blocks above it are empty)</summary>
+		/// <param name="col">Column whose height is requested (0 being the rightmost column)</param>
+		int getColumnHeight(int col) const;
+
+		/// <summary>Returns the number of full blocks of the grid</summary>
+		int getBlocksCount() const;
+
 		// Evaluation utilities
 		/// <summary>Returns the value of a full line (e.g. 1023 if the width's value is 10)</summary>
-		unsigned int getCompleteLine() const;
+		Row getCompleteLine() const;
 
 		/// <summary>Returns the number of transition from 1 to 0 and 0 to 1 in columns in the grid</summary>
+		/// <remarks>Kept up to date by fitPiece, thus returned in constant time</remarks>
 		int columnTransitions() const;
 
 		/// <summary>Returns the number of transition from 1 to 0 and 0 to 1 in rows in the grid</summary>
+		/// <remarks>Kept up to date by fitPiece, thus returned in constant time</remarks>
 		int rowTransitions() const;
 
 		/// <summary>Returns the number of bits set to 0 that have a bit set to 1 in the same column above them</summary>
+		/// <remarks>Kept up to date by fitPiece, thus returned in constant time</remarks>
 		int cellars() const;
 
 		/// <summary>Returns a value relative to the number of wells in the grid. Each well is weighted depending on its depth</summary>
@@ -76,21 +128,74 @@ namespace TetrisAI {
 		int emptyBlocksDown(int row, int col) const;
 
 	private:
-		std::vector<unsigned int> content;
+		/// <summary>Column words stored inline, of which only the words in use are copied</summary>
+		struct ColumnWords {
+			/// <param name="count">Number of words in use (0 if the columns are not maintained)</param>
+			ColumnWords(short count);
+			ColumnWords(const ColumnWords& other);
+			ColumnWords& operator=(const ColumnWords& other);
+
+			unsigned int& operator[](int col) { return words[col]; }
+			unsigned int operator[](int col) const { return words[col]; }
+			unsigned int* data() { return words.data(); }
+			const unsigned int* data() const { return words.data(); }
+
+			std::array<unsigned int, maxWidth> words;
+			short count;
+		};
+
+		/// <summary>Rows of the grid stored inline so that copying a grid does not require any heap allocation (only the first height rows are used)</summary>
+		std::array<Row, maxHeight> content;
+		/// <summary>Columns of the grid (bit r being the block of row r), one word per column with the RowAndColumnMajor layout and none otherwise (RowMajor copies then skip them)</summary>
+		ColumnWords columns;
+		/// <summary>Height of each column of the grid, kept up to date as pieces land and rows are removed</summary>
+		std::array<short, maxWidth> columnHeights;
+		Layout layout;
 		short width;
+		short height;
 		short topHeight;
 
+		// Features cached as pieces land: a move only updates the contribution of the rows it changed
+		/// <summary>Row transitions of every row of the grid, including the empty rows above the top height</summary>
+		int rowTransitionsSum;
+		/// <summary>Column transitions of the grid</summary>
+		int columnTransitionsSum;
+		/// <summary>Sum of the heights of all columns</summary>
+		int heightsSum;
+		/// <summary>Number of full blocks in the grid</summary>
+		int blocksCount;
+		/// <summary>Xor of the hashes of all rows of the grid (see rowHash)</summary>
+		std::uint64_t hash;
+
+		/// <summary>Returns the contribution of a row to the hash of the grid (Zobrist-like: each row index has its own random key, empty rows do not contribute)</summary>
+		/// <param name="value">Content of the row</param>
+		/// <param name="row">Index of the row</param>
+		static std::uint64_t rowHash(Row value, int row);
+
+		/// <summary>Returns the xor of the hashes of the rows in [firstRow, endRow)</summary>
+		std::uint64_t rowsHash(int firstRow, int endRow) const;
+
 		/// <summary>Returns -1 if it can not fit. Else it returns the index of the lowest row where the piece would fit</summary>
-		/// <param name="piece">Content of the piece that has to enter the grid</param>
-		int findFittingRow(const std::vector<unsigned int>& piece) const;
+		/// <param name="piece">Rotated and translated piece that has to enter the grid</param>
+		int findFittingRow(const PlacedPiece& piece) const;
 
 		/// <summary>Returns false if some parts of the piece are out of the grid in terms of width</summary>
-		/// <param name="piece">Content of the piece that must be tested</param>
-		bool isPieceTranslationValid(const std::vector<unsigned int>& piece) const;
-
-		/// <summary>Delete one row and translate down all rows above</summary>
-		/// <param name="index">Row that must be deleted</param>
-		void removeRow(unsigned int index);
+		/// <param name="piece">Rotated and translated piece that must be tested</param>
+		bool isPieceTranslationValid(const PlacedPiece& piece) const;
+
+		/// <summary>Merge the piece in the grid at the given landing row and clear the complete lines</summary>
+		/// <param name="piece">Rotated and translated piece that lands in the grid</param>
+		/// <param name="landingRow">Row where the bottom of the piece lands (it must be a valid landing row)</param>
+		MoveResult mergePiece(const PlacedPiece& piece, int landingRow);
+
+		/// <summary>Returns the number of column transitions between each row of [firstRow, endRow] and the row below it</summary>
+		/// <param name="firstRow">Lowest row considered (the row below the grid is full)</param>
+		/// <param name="endRow">Highest row considered (rows above the grid are empty)</param>
+		int columnTransitionsBetween(int firstRow, int endRow) const;
+
+		/// <summary>Delete the given rows in a single pass, translate down all rows above them and update the columns accordingly</summary>
+		/// <param name="fullRows">Rows that must be deleted (bit r being row r), the top height must not have been updated yet</param>
+		void removeRows(unsigned int fullRows);
 	};
 
 }
@@ -67,12 +67,12 @@ sf::Vector2u GridView::getBlockSize() const
 	return drawableBlockSize;
 }
 
-void GridView::refreshGrid(const std::vector<unsigned int>& gridContent)
+void GridView::refreshGrid(const std::vector<TetrisAI::Row>& gridContent)
 {
 	unsigned int maxRow = (gridContent.size() > height) ? height : gridContent.size();
 	for (unsigned int row = 0; row < maxRow; row++)
 	{
-		unsigned int rowValue = gridContent[row];
+		TetrisAI::Row rowValue = gridContent[row];
 		for (unsigned int col = 0; col < width; col++)
 		{
 			// retrieve a pointer of the quad we need to update
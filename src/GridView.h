@@ -2,6 +2,8 @@
 #define TETRISAI_GRIDVIEW_H
 
 #include <SFML/Graphics.hpp>
+#include <vector>
+#include "Row.h"
 
 class GridView : public sf::Drawable, public sf::Transformable {
 	
@@ -12,7 +14,7 @@ public:
 	static const sf::Color emptyTileColor;
 
 	GridView(sf::Vector2<unsigned short> tileSize, unsigned short outerBorderSize, unsigned short innerBorderSize, unsigned short width, unsigned short height);
-	void refreshGrid(const std::vector<unsigned int>& gridContent);
+	void refreshGrid(const std::vector<TetrisAI::Row>& gridContent);
 	sf::Vector2u getBlockSize() const;
 
 private:
@@ -1,7 +1,18 @@
 #include "Heuristic.h"
+#include <stdexcept>
 
 namespace TetrisAI {
 
 	const float Heuristic::gameOverEvaluation = -100000;
 
+	bool Heuristic::getEvaluationBounds(const GameState& /*gs*/, int /*depth*/, int /*squares*/, Bounds& /*bounds*/)
+	{
+		return false;
+	}
+
+	float Heuristic::invertBranch(const GameState& /*gs*/, float /*evaluation*/)
+	{
+		throw std::logic_error("This heuristic does not bound its evaluations: its branch evaluations cannot be inverted.");
+	}
+
 }
\ No newline at end of file
@@ -9,6 +9,12 @@ namespace TetrisAI {
 	public:
 		static const float gameOverEvaluation;
 
+		/// <summary>Range of evaluations</summary>
+		struct Bounds {
+			float lower;
+			float upper;
+		};
+
 		/// <summary>Outputs a value that grades the given GameState</summary>
 		/// <param name="gs">Game state that should be evaluated</param>
 		/// <returns>Evaluation of the game state</returns>
@@ -19,6 +25,19 @@ namespace TetrisAI {
 		/// <param name="childrenEvaluation">Evaluation of the children of the corresponding GameStateNode</param>
 		/// <returns>Evaluation of the game state that includes its children's evaluation</returns>
 		virtual float evaluateBranch(const GameState& gs, float childrenEvaluation) = 0;
+
+		/// <summary>Gives bounds of the evaluations of the nodes of any decision tree considering a certain number of moves from the given game state, which allow it to be pruned</summary>
+		/// <param name="gs">Game state at the root of the decision tree</param>
+		/// <param name="depth">Number of moves considered by the decision tree</param>
+		/// <param name="squares">Largest number of squares of the polyominos that may be played</param>
+		/// <param name="bounds">Bounds of the evaluations of the root and of every node below it</param>
+		/// <returns>False if the heuristic cannot bound its evaluations (the default), in which case decision trees cannot be pruned</returns>
+		virtual bool getEvaluationBounds(const GameState& gs, int depth, int squares, Bounds& bounds);
+
+		/// <summary>Returns the children evaluation for which evaluateBranch would give the given evaluation</summary>
+		/// <remarks>Only needed if getEvaluationBounds returns true: evaluateBranch must then be increasing with the children evaluation</remarks>
+		/// <exception cred="std::logic_error">Thrown by default since evaluateBranch cannot be inverted</exception>
+		virtual float invertBranch(const GameState& gs, float evaluation);
 	};
 
 }
@@ -1,20 +1,62 @@
 #include "HeuristicStrategy.h"
 #include "GameStateNode.h"
+#include <algorithm>
+#include <chrono>
 #include <stdexcept>
+#include <thread>
 
 namespace TetrisAI {
 
-	HeuristicStrategy::HeuristicStrategy(Heuristic& heuristic, unsigned int depth, bool useMultithreading) :
-		heuristic(heuristic), depth(depth), decisionTreeRoot(nullptr), useMultithreading(useMultithreading)
+	HeuristicStrategy::HeuristicStrategy(Heuristic& heuristic, unsigned int depth, bool useMultithreading, TranspositionTable* transpositionTable, std::size_t memoryBudget,
+		ChanceSampling* chanceSampling, bool usePondering, LazyExpansion* lazyExpansion) :
+		heuristic(heuristic), depth(depth), decisionTreeRoot(nullptr), useMultithreading(useMultithreading), transpositionTable(transpositionTable),
+		threadPool(nullptr), lastMoveStatistics(), memoryBudget(memoryBudget > 0 ? std::make_unique<MemoryBudget>(memoryBudget) : nullptr), lastMoveMemory(),
+		chanceSampling(chanceSampling), decisions(0), lazyExpansion(lazyExpansion), usePondering(usePondering), ponderingCancelled(false), pondering(), lastPondering()
 	{
 		if (depth > maxDepth)
 		{
 			throw std::invalid_argument("This implementation does not allow decision trees to consider more than 4 moves at once.");
 		}
+
+		if (useMultithreading)
+		{
+			// The thread deciding the move runs tasks as well while it waits for the workers
+			unsigned cores(std::thread::hardware_concurrency());
+			threadPool = std::make_unique<ThreadPool>(cores > 1 ? cores - 1 : 1);
+		}
+	}
+
+	HeuristicStrategy::~HeuristicStrategy()
+	{
+		stopPondering();
 	}
 
 	Transformation HeuristicStrategy::decideMove(const GameState& gs, std::vector<Polyomino>& possiblePolyominos)
 	{
+		// The subtree built meanwhile is kept: the update below only builds what the pondering did not
+		stopPondering();
+		lastPondering = pondering;
+		pondering = PonderingStatistics();
+		// What the pondering had no time to destroy is destroyed now, so that discarded subtrees do not pile up
+		discardedNodes.clear();
+		DiscardedNodes* discarded(usePondering ? &discardedNodes : nullptr);
+
+		if (threadPool)
+		{
+			threadPool->resetStatistics();
+		}
+		if (memoryBudget)
+		{
+			memoryBudget->resetStatistics();
+		}
+		lastMoveMemory.peakBytes = MemoryBudget::getBytesInUse();
+		if (chanceSampling)
+		{
+			// The layers built during this decision draw other polyominos than the ones built before
+			chanceSampling->setRound(decisions);
+		}
+		decisions++;
+
 		// If the tree has not been initialized
 		if (!decisionTreeRoot)
 		{
@@ -22,11 +64,11 @@ namespace TetrisAI {
 		}
 		else
 		{
-			Polyomino* lastAddedPolyomino(gs.polyominoQueueTail());
+			const Polyomino* lastAddedPolyomino(gs.polyominoQueueTail());
 			if (lastAddedPolyomino != nullptr)
 			{
 				// Update tree content and nodes evaluation by building new level if necessary
-				decisionTreeRoot->updateTree(lastAddedPolyomino, depth, possiblePolyominos, heuristic, useMultithreading);	
+				decisionTreeRoot->updateTree(lastAddedPolyomino, depth, SearchContext(possiblePolyominos, heuristic, transpositionTable, threadPool.get(), memoryBudget.get(), chanceSampling, nullptr, discarded, lazyExpansion), useMultithreading);
 			}
 			else
 			{
@@ -34,19 +76,96 @@ namespace TetrisAI {
 			}
 		}
 
-		// Replace the root by its best child (trigger deletion of siblings and their subtrees)
-		decisionTreeRoot = decisionTreeRoot->extractBestChild();
+		// The whole tree is held until the root is replaced
+		lastMoveMemory.peakBytes = std::max(lastMoveMemory.peakBytes, MemoryBudget::getBytesInUse());
+
+		// Replace the root by its best child (trigger deletion of siblings and their subtrees, unless the pondering thread destroys them)
+		std::unique_ptr<DecisionTreeNode> previousRoot(std::move(decisionTreeRoot));
+		decisionTreeRoot = previousRoot->extractBestChild();
+		if (discarded != nullptr)
+		{
+			discarded->add(std::move(previousRoot));
+		}
+		previousRoot.reset();
+		if (threadPool)
+		{
+			lastMoveStatistics = threadPool->getStatistics();
+		}
+		lastMoveMemory.bytesInUse = MemoryBudget::getBytesInUse();
+		if (memoryBudget)
+		{
+			lastMoveMemory.peakBytes = std::max(lastMoveMemory.peakBytes, memoryBudget->getPeakBytes());
+			lastMoveMemory.collapses = memoryBudget->getCollapses();
+		}
 
 		if (decisionTreeRoot->isGameOver())
 		{
 			return Transformation(-1, -1);
 		}
+		if (usePondering)
+		{
+			startPondering(possiblePolyominos);
+		}
 		return decisionTreeRoot->getPolyominoMove();
 	}
 
+	ThreadPool::Statistics HeuristicStrategy::getLastMoveStatistics() const
+	{
+		return lastMoveStatistics;
+	}
+
+	HeuristicStrategy::MemoryStatistics HeuristicStrategy::getLastMoveMemory() const
+	{
+		return lastMoveMemory;
+	}
+
+	HeuristicStrategy::PonderingStatistics HeuristicStrategy::getLastPondering() const
+	{
+		return lastPondering;
+	}
+
+	void HeuristicStrategy::startPondering(const std::vector<Polyomino>& possiblePolyominos)
+	{
+		// The possible polyominos are the same for the whole game: they are only copied once
+		if (ponderingPolyominos.size() != possiblePolyominos.size())
+		{
+			ponderingPolyominos = possiblePolyominos;
+		}
+
+		ponderingCancelled = false;
+		ponderingThread = std::thread([this]() {
+			auto start(std::chrono::steady_clock::now());
+			discardedNodes.clear(&ponderingCancelled);
+			// Without a new polyomino, the update builds the missing layers of the subtree from the polyominos known and considers every possible one
+			// beyond them: the next update only has to trim the layer of the polyomino drawn meanwhile
+			decisionTreeRoot->updateTree(nullptr, depth, SearchContext(ponderingPolyominos, heuristic, transpositionTable, threadPool.get(), memoryBudget.get(), chanceSampling,
+				&ponderingCancelled, nullptr, lazyExpansion), useMultithreading);
+			pondering.completed = !ponderingCancelled;
+			pondering.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		});
+	}
+
+	void HeuristicStrategy::waitPondering()
+	{
+		if (ponderingThread.joinable())
+		{
+			ponderingThread.join();
+		}
+	}
+
+	void HeuristicStrategy::stopPondering()
+	{
+		if (ponderingThread.joinable())
+		{
+			ponderingCancelled = true;
+			ponderingThread.join();
+		}
+	}
+
 	void HeuristicStrategy::initializeTree(const GameState& gs, std::vector<Polyomino>& possiblePolyominos)
 	{
-		decisionTreeRoot = std::make_unique<GameStateNode>(gs, depth, possiblePolyominos, heuristic);
+		decisionTreeRoot = std::make_unique<GameStateNode>(gs, depth, SearchContext(possiblePolyominos, heuristic, transpositionTable, threadPool.get(), memoryBudget.get(), chanceSampling, nullptr, nullptr, lazyExpansion),
+			useMultithreading);
 	}
 
 }
\ No newline at end of file
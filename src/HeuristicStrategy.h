@@ -4,6 +4,13 @@
 #include "AIStrategy.h"
 #include "Heuristic.h"
 #include "DecisionTreeNode.h"
+#include "TranspositionTable.h"
+#include "ThreadPool.h"
+#include "MemoryBudget.h"
+#include "ChanceSampling.h"
+#include "LazyExpansion.h"
+#include <atomic>
+#include <thread>
 
 namespace TetrisAI {
 
@@ -12,29 +19,103 @@ namespace TetrisAI {
 	public:
 		const static int maxDepth = 4;
 
+		/// <summary>Memory held by the nodes of the decision tree during a decision</summary>
+		struct MemoryStatistics {
+			/// <summary>Bytes held once the move is decided (the subtree kept for the next decision)</summary>
+			std::size_t bytesInUse;
+			/// <summary>Largest number of bytes held during the decision (only sampled as the nodes are evaluated)</summary>
+			std::size_t peakBytes;
+			/// <summary>Number of subtrees collapsed during the decision to stay within the memory budget</summary>
+			unsigned long long collapses;
+		};
+
+		/// <summary>Work done on the retained subtree between the previous decision and the last one</summary>
+		struct PonderingStatistics {
+			/// <summary>Time spent refining the subtree before it was completed or cancelled</summary>
+			double seconds;
+			/// <summary>True if the subtree was refined to the full depth before the decision cancelled it</summary>
+			bool completed;
+		};
+
 		/// <param name="heuristic">Heuristic that should be used to eveluate decision tree nodes</param>
 		/// <param name="depth">Number of moves to be considered in advance</param>
-		/// <param name="useMultithreading">Toggle the use of multithreading to enhance the speed of decision making</param>
-		HeuristicStrategy(Heuristic& heuristic, unsigned int depth, bool useMultithreading);
+		/// <param name="useMultithreading">Toggle the use of multithreading to enhance the speed of decision making (the strategy then keeps a pool of threads for its whole life)</param>
+		/// <param name="transpositionTable">Table used to share the evaluation of equal positions reached through different moves (nullptr to disable it)</param>
+		/// <param name="memoryBudget">Bytes the nodes should not hold more of, the least valuable subtrees being collapsed to their evaluation beyond it (0 to disable it)</param>
+		/// <param name="chanceSampling">Sampling of the polyominos expanded when the next polyomino is unknown, drawn anew for the layers built at each decision (nullptr to expand all of them)</param>
+		/// <param name="usePondering">
+		/// Toggle the building of the retained subtree on a background thread between the decisions, the polyomino coming after the known ones being
+		/// considered unknown (the subtree is left as it is once the next decision starts)
+		/// </param>
+		/// <param name="lazyExpansion">Selection of the moves expanded by the nodes, the others being dropped from the tree (nullptr to expand every move)</param>
+		HeuristicStrategy(Heuristic& heuristic, unsigned int depth, bool useMultithreading, TranspositionTable* transpositionTable = nullptr, std::size_t memoryBudget = 0,
+			ChanceSampling* chanceSampling = nullptr, bool usePondering = false, LazyExpansion* lazyExpansion = nullptr);
+		virtual ~HeuristicStrategy();
 
 		/// <summary>Evaluate the possible outcomes from the given game state and outputs the best moves based on an heuristic</summary>
 		/// <param name="gs">Game state which should have at least one pending polyomino to be played</param>
 		/// <param name="possiblePolyominos">List of potential polyominos to populate the decision tree if needed</param>
 		virtual Transformation decideMove(const GameState& gs, std::vector<Polyomino>& possiblePolyominos);
 
+		/// <summary>Returns the time, core utilization and tasks of the thread pool during the last decision (zeros if multithreading is not used)</summary>
+		ThreadPool::Statistics getLastMoveStatistics() const;
+
+		/// <summary>Returns the memory held by the decision tree during the last decision</summary>
+		MemoryStatistics getLastMoveMemory() const;
+
+		/// <summary>Returns the pondering collected by the last decision (zeros if pondering is not used)</summary>
+		PonderingStatistics getLastPondering() const;
+
+		/// <summary>Waits for the pondering started by the last decision to complete (returns at once if there is none), the next decision then using the full subtree</summary>
+		void waitPondering();
+
 	private:
 		/// <summary>Initialize the decision tree (should be called once before the first decision)</summary>
 		/// <param name="gs">Game state that will serve as a basis for the decision tree</param>
 		/// <param name="possiblePolyominos">List of potential polyominos to populate the decision tree if needed</param>
 		void initializeTree(const GameState& gs, std::vector<Polyomino>& possiblePolyominos);
 
+		/// <summary>Starts building the retained subtree to the full depth on the pondering thread</summary>
+		/// <param name="possiblePolyominos">List of potential polyominos to populate the decision tree</param>
+		void startPondering(const std::vector<Polyomino>& possiblePolyominos);
+
+		/// <summary>Cancels the pondering and waits for the pondering thread, the subtree being left consistent</summary>
+		void stopPondering();
+
 		/// <summary>Heuristic that should be used to evaluate game states</summary>
 		Heuristic& heuristic;
 		/// <summary>Number of moves to be considered in advance</summary>
 		unsigned int depth;
 
 		bool useMultithreading;
+		/// <summary>Table shared by every decision tree built by the strategy (may be nullptr)</summary>
+		TranspositionTable* transpositionTable;
+		/// <summary>Threads updating the subtrees when multithreading is used (nullptr otherwise)</summary>
+		std::unique_ptr<ThreadPool> threadPool;
+		ThreadPool::Statistics lastMoveStatistics;
+		/// <summary>Ceiling of the memory held by the decision tree (nullptr if it is not bounded)</summary>
+		std::unique_ptr<MemoryBudget> memoryBudget;
+		MemoryStatistics lastMoveMemory;
+		/// <summary>Sampling shared by every decision tree built by the strategy (may be nullptr)</summary>
+		ChanceSampling* chanceSampling;
+		/// <summary>Number of decisions taken, used as the round of the chance sampling</summary>
+		unsigned decisions;
+		/// <summary>Selection of the moves expanded, shared by every decision tree built by the strategy (may be nullptr)</summary>
+		LazyExpansion* lazyExpansion;
 		std::unique_ptr<DecisionTreeNode> decisionTreeRoot;
+
+		bool usePondering;
+		/// <summary>Thread building the retained subtree between the decisions (not joinable when no pondering is running)</summary>
+		std::thread ponderingThread;
+		/// <summary>Set by the decisions to stop the pondering</summary>
+		std::atomic<bool> ponderingCancelled;
+		/// <summary>Subtrees discarded by the decisions, destroyed by the pondering thread before it builds the retained subtree</summary>
+		DiscardedNodes discardedNodes;
+		/// <summary>Copy of the possible polyominos, which the caller may destroy while the pondering runs</summary>
+		std::vector<Polyomino> ponderingPolyominos;
+		/// <summary>Written by the pondering thread, read once it is joined</summary>
+		PonderingStatistics pondering;
+		PonderingStatistics lastPondering;
 	};
 
 }
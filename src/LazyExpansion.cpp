@@ -0,0 +1,119 @@
+#include "LazyExpansion.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace TetrisAI {
+
+	LazyExpansion::LazyExpansion(unsigned width, float margin) : width(width), margin(margin), generatedMoves(0), expandedMoves(0)
+	{
+		if (width == 0)
+		{
+			throw std::invalid_argument("A node must expand at least one move.");
+		}
+		if (!(margin >= 0))
+		{
+			throw std::invalid_argument("The margin below the best move must be positive.");
+		}
+	}
+
+	void LazyExpansion::selectMoves(const GameState& gs, std::vector<Placement>& placements, Heuristic& heuristic)
+	{
+		std::vector<float> evaluations(placements.size());
+		for (unsigned i = 0; i < placements.size(); i++)
+		{
+			GameState postMoveState(gs);
+			postMoveState.play(placements[i]);
+			evaluations[i] = heuristic.evaluate(postMoveState);
+		}
+
+		std::vector<Placement> selected;
+		for (auto i : select(evaluations))
+		{
+			selected.push_back(placements[i]);
+		}
+		placements.swap(selected);
+	}
+
+	void LazyExpansion::selectChildren(std::vector<std::unique_ptr<DecisionTreeNode>>& children, std::vector<std::unique_ptr<DecisionTreeNode>>& dropped)
+	{
+		std::vector<float> evaluations(children.size());
+		for (unsigned i = 0; i < children.size(); i++)
+		{
+			evaluations[i] = children[i]->getNodeEvaluation();
+		}
+
+		std::vector<unsigned> kept(select(evaluations));
+		if (kept.size() == children.size())
+		{
+			return;
+		}
+		std::vector<std::unique_ptr<DecisionTreeNode>> selected;
+		unsigned next(0);
+		for (unsigned i = 0; i < children.size(); i++)
+		{
+			if (next < kept.size() && kept[next] == i)
+			{
+				selected.push_back(std::move(children[i]));
+				next++;
+			}
+			else
+			{
+				dropped.push_back(std::move(children[i]));
+			}
+		}
+		children.swap(selected);
+	}
+
+	std::vector<unsigned> LazyExpansion::select(const std::vector<float>& evaluations)
+	{
+		std::vector<unsigned> order(evaluations.size());
+		for (unsigned i = 0; i < order.size(); i++)
+		{
+			order[i] = i;
+		}
+		// Best moves first (ties keep the order of the moves)
+		std::stable_sort(order.begin(), order.end(), [&evaluations](unsigned a, unsigned b) {
+			return evaluations[a] > evaluations[b];
+		});
+
+		unsigned expanded(0);
+		while (expanded < order.size() && expanded < width && (expanded == 0 || evaluations[order[expanded]] >= evaluations[order[0]] - margin))
+		{
+			expanded++;
+		}
+		generatedMoves += order.size();
+		expandedMoves += expanded;
+
+		// The moves kept go back to their original order, so that ties between their subtrees are broken as in a full tree
+		order.resize(expanded);
+		std::sort(order.begin(), order.end());
+		return order;
+	}
+
+	void LazyExpansion::resetStatistics()
+	{
+		generatedMoves = 0;
+		expandedMoves = 0;
+	}
+
+	unsigned long long LazyExpansion::getGeneratedMoves() const
+	{
+		return generatedMoves;
+	}
+
+	unsigned long long LazyExpansion::getExpandedMoves() const
+	{
+		return expandedMoves;
+	}
+
+	unsigned LazyExpansion::getWidth() const
+	{
+		return width;
+	}
+
+	float LazyExpansion::getMargin() const
+	{
+		return margin;
+	}
+
+}
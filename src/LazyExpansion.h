@@ -0,0 +1,71 @@
+#ifndef TETRISAI_LAZYEXPANSION_H
+#define TETRISAI_LAZYEXPANSION_H
+
+#include <atomic>
+#include <limits>
+#include <vector>
+#include "GameState.h"
+#include "Heuristic.h"
+#include "Placement.h"
+#include "DecisionTreeNode.h"
+
+namespace TetrisAI {
+
+	/// <summary>
+	/// Selection of the moves whose subtree is built by the nodes whose next polyomino is known.
+	///
+	/// Every move is first given the evaluation of the game state it leads to, without any subtree (a single ply), and the moves are
+	/// expanded from the best one on: the expansion stops once enough moves are expanded or once the next move is evaluated too far below
+	/// the best one. The other moves are not kept in the tree. Nodes whose children are only evaluated (a single move left) evaluate every
+	/// move anyway: they are not concerned.
+	///
+	/// Since the tree is updated one layer at a time, the children of a node built as leaves are only selected once the tree is updated
+	/// from the node, their evaluation being the single ply one. The selection is then repeated at each update, on the evaluations of
+	/// their subtrees.
+	/// </summary>
+	/// <remarks>
+	/// The cutoffs are not exact: a move evaluated poorly on its own may still lead to the best subtree. Exact cutoffs from the evaluation
+	/// bounds of the heuristic (see ExpectimaxStrategy) only exist for the layers averaging polyominos: a move keeping the best subtree could
+	/// only be skipped if the upper bound of its subtree fell below the evaluation of a sibling, which loose bounds never do.
+	/// </remarks>
+	class LazyExpansion {
+
+	public:
+		/// <param name="width">Largest number of moves expanded by a node</param>
+		/// <param name="margin">Moves evaluated more than margin below the best move are not expanded (infinity to only bound their number)</param>
+		/// <exception cred="std::invalid_argument">Thrown if width is 0 or margin is negative</exception>
+		LazyExpansion(unsigned width, float margin = std::numeric_limits<float>::infinity());
+
+		/// <summary>Keeps the moves that should be expanded from the given game state, in their original order</summary>
+		/// <param name="gs">Game state the moves are played from</param>
+		/// <param name="placements">Every move of the coming polyomino, replaced by the ones to expand</param>
+		/// <param name="heuristic">Heuristic evaluating the game state of each move</param>
+		void selectMoves(const GameState& gs, std::vector<Placement>& placements, Heuristic& heuristic);
+
+		/// <summary>Keeps the children of a node that should be expanded, in their original order</summary>
+		/// <param name="children">Children reached by playing a move, replaced by the ones to expand</param>
+		/// <param name="dropped">Receives the children that are not kept</param>
+		void selectChildren(std::vector<std::unique_ptr<DecisionTreeNode>>& children, std::vector<std::unique_ptr<DecisionTreeNode>>& dropped);
+
+		void resetStatistics();
+		/// <summary>Returns the number of moves among which the nodes selected since the statistics were reset</summary>
+		unsigned long long getGeneratedMoves() const;
+		/// <summary>Returns the number of moves the nodes selected to be expanded since the statistics were reset</summary>
+		unsigned long long getExpandedMoves() const;
+
+		unsigned getWidth() const;
+		float getMargin() const;
+
+	private:
+		/// <summary>Returns the indices of the moves to expand in increasing order</summary>
+		std::vector<unsigned> select(const std::vector<float>& evaluations);
+
+		unsigned width;
+		float margin;
+		std::atomic<unsigned long long> generatedMoves;
+		std::atomic<unsigned long long> expandedMoves;
+	};
+
+}
+
+#endif
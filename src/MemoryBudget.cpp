@@ -0,0 +1,61 @@
+#include "MemoryBudget.h"
+#include "GameStateNode.h"
+#include "PolyominoNode.h"
+#include "NodePool.h"
+#include <memory>
+#include <stdexcept>
+
+namespace TetrisAI {
+
+	MemoryBudget::MemoryBudget(std::size_t maxBytes) : maxBytes(maxBytes), peakBytes(0), collapses(0)
+	{
+		if (maxBytes == 0)
+		{
+			throw std::invalid_argument("A memory budget must allow some bytes.");
+		}
+	}
+
+	std::size_t MemoryBudget::getBytesInUse()
+	{
+		// Every node but the roots is pointed to by a slot of the children of its parent
+		const std::size_t slot(sizeof(std::unique_ptr<DecisionTreeNode>));
+		return NodePool<GameStateNode>::getNodesInUse() * (sizeof(GameStateNode) + slot) + NodePool<PolyominoNode>::getNodesInUse() * (sizeof(PolyominoNode) + slot);
+	}
+
+	std::size_t MemoryBudget::getMaxBytes() const
+	{
+		return maxBytes;
+	}
+
+	bool MemoryBudget::isExceeded()
+	{
+		std::size_t bytes(getBytesInUse());
+		std::size_t peak(peakBytes.load(std::memory_order_relaxed));
+		while (bytes > peak && !peakBytes.compare_exchange_weak(peak, bytes, std::memory_order_relaxed))
+		{
+		}
+		return bytes > maxBytes;
+	}
+
+	void MemoryBudget::recordCollapse()
+	{
+		collapses.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void MemoryBudget::resetStatistics()
+	{
+		peakBytes = getBytesInUse();
+		collapses = 0;
+	}
+
+	std::size_t MemoryBudget::getPeakBytes() const
+	{
+		return peakBytes;
+	}
+
+	unsigned long long MemoryBudget::getCollapses() const
+	{
+		return collapses;
+	}
+
+}
@@ -0,0 +1,50 @@
+#ifndef TETRISAI_MEMORYBUDGET_H
+#define TETRISAI_MEMORYBUDGET_H
+
+#include <atomic>
+#include <cstddef>
+
+namespace TetrisAI {
+
+	/// <summary>
+	/// Ceiling on the memory held by the nodes of the decision trees, checked by each node once its children are evaluated.
+	///
+	/// Over the ceiling, a node collapses the subtrees of its children, the lowest evaluated first: the children keep their evaluation,
+	/// so the decision is not changed, and their subtrees are rebuilt if the tree is updated from them (as if their evaluation came from
+	/// a transposition table). The children of the nodes being built are only collapsed once their parent is evaluated: the ceiling may
+	/// be exceeded meanwhile by these children and their own children.
+	/// </summary>
+	/// <remarks>The memory is counted over every decision tree of the program, through the pools the nodes are allocated from</remarks>
+	class MemoryBudget {
+
+	public:
+		/// <param name="maxBytes">Number of bytes the nodes should not hold more of</param>
+		/// <exception cred="std::invalid_argument">Thrown if maxBytes is 0</exception>
+		MemoryBudget(std::size_t maxBytes);
+
+		/// <summary>Returns the number of bytes held by the nodes in use and the slots of their parents pointing to them</summary>
+		static std::size_t getBytesInUse();
+
+		std::size_t getMaxBytes() const;
+
+		/// <summary>Returns true if the nodes hold more than the ceiling (the bytes in use are also recorded for the peak)</summary>
+		bool isExceeded();
+
+		/// <summary>Counts a subtree collapsed to the evaluation of its root</summary>
+		void recordCollapse();
+
+		void resetStatistics();
+		/// <summary>Returns the largest number of bytes in use seen by isExceeded since the statistics were reset</summary>
+		std::size_t getPeakBytes() const;
+		/// <summary>Returns the number of subtrees collapsed since the statistics were reset</summary>
+		unsigned long long getCollapses() const;
+
+	private:
+		std::size_t maxBytes;
+		std::atomic<std::size_t> peakBytes;
+		std::atomic<unsigned long long> collapses;
+	};
+
+}
+
+#endif
@@ -0,0 +1,311 @@
+#include "MonteCarloStrategy.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace TetrisAI {
+
+	namespace {
+		/// <summary>Weight of the exploration term of the UCT score, values being normalized between 0 and 1</summary>
+		const float explorationConstant(0.5f);
+	}
+
+	MonteCarloStrategy::Node::Node(const GameState& state, bool isAfterMove) :
+		state(state), isAfterMove(isAfterMove), isTerminal(state.isGameOver()), visits(0), valueSum(0)
+	{
+	}
+
+	MonteCarloStrategy::SearchTree::SearchTree(unsigned int seed) :
+		generator(seed), root(nullptr), lowest(0), highest(0), rollouts(0), nodes(0)
+	{
+	}
+
+	MonteCarloStrategy::MonteCarloStrategy(Heuristic& heuristic, unsigned int rollouts, unsigned int rolloutDepth, unsigned int threads, std::chrono::microseconds timeBudget, unsigned int seed) :
+		heuristic(heuristic), rollouts(rollouts), rolloutDepth(rolloutDepth), timeBudget(timeBudget), statistics(), threadPool(nullptr),
+		possiblePolyominos(nullptr), hasDeadline(false)
+	{
+		if (rolloutDepth > maxDepth)
+		{
+			throw std::invalid_argument("A rollout cannot play more than 32 moves.");
+		}
+		if (threads == 0)
+		{
+			throw std::invalid_argument("A Monte Carlo search needs at least one thread.");
+		}
+		if (rollouts == 0 && timeBudget == std::chrono::microseconds::zero())
+		{
+			throw std::invalid_argument("A Monte Carlo search must be limited by a number of rollouts or by a time budget.");
+		}
+
+		// Each tree draws its own polyominos, the same ones from one run to another whatever the scheduling of the threads
+		for (unsigned int i = 0; i < threads; i++)
+		{
+			trees.emplace_back(seed + i);
+		}
+		if (threads > 1)
+		{
+			threadPool = std::make_unique<ThreadPool>(threads - 1);
+		}
+	}
+
+	Transformation MonteCarloStrategy::decideMove(const GameState& gs, std::vector<Polyomino>& possiblePolyominos)
+	{
+		const Polyomino* comingPolyomino(gs.polyominoQueueHead());
+		if (comingPolyomino == nullptr)
+		{
+			throw std::invalid_argument("Given game state does not have any pending polyomino");
+		}
+
+		this->possiblePolyominos = &possiblePolyominos;
+		hasDeadline = timeBudget != std::chrono::microseconds::zero();
+		deadline = Clock::now() + timeBudget;
+
+		// The rollouts are shared between the trees, the first trees doing the remaining ones
+		unsigned int treeCount(trees.size());
+		if (threadPool)
+		{
+			ThreadPool::TaskGroup group(*threadPool);
+			for (unsigned int i = 0; i < treeCount; i++)
+			{
+				unsigned int treeRollouts(rollouts / treeCount + (i < rollouts % treeCount ? 1 : 0));
+				group.run([this, i, &gs, treeRollouts]() { growTree(trees[i], gs, treeRollouts); });
+			}
+			group.wait();
+		}
+		else
+		{
+			growTree(trees[0], gs, rollouts);
+		}
+
+		// Visits of the moves of the coming polyomino are summed over the trees, their values breaking ties
+		std::vector<Placement> placements(gs.getGrid().computePlacements(*comingPolyomino));
+		std::vector<unsigned long long> visits(placements.size(), 0);
+		std::vector<double> valueSums(placements.size(), 0);
+		for (auto& tree : trees)
+		{
+			for (unsigned int m = 0; m < tree.root->children.size() && m < placements.size(); m++)
+			{
+				if (tree.root->children[m])
+				{
+					visits[m] += tree.root->children[m]->visits;
+					valueSums[m] += tree.root->children[m]->valueSum;
+				}
+			}
+			statistics.rollouts += tree.rollouts;
+			statistics.treeNodes += tree.nodes;
+			tree.rollouts = 0;
+			tree.nodes = 0;
+			tree.root.reset();
+		}
+
+		int best(-1);
+		for (unsigned int m = 0; m < placements.size(); m++)
+		{
+			if (visits[m] > 0 && (best < 0 || visits[m] > visits[best] ||
+				(visits[m] == visits[best] && valueSums[m] / visits[m] > valueSums[best] / visits[best])))
+			{
+				best = m;
+			}
+		}
+
+		if (best < 0)
+		{
+			return Transformation(-1, -1);
+		}
+		GameState bestState(gs);
+		bestState.play(placements[best]);
+		if (bestState.isGameOver())
+		{
+			return Transformation(-1, -1);
+		}
+		return placements[best].transformation;
+	}
+
+	MonteCarloStrategy::Statistics MonteCarloStrategy::getStatistics() const
+	{
+		return statistics;
+	}
+
+	void MonteCarloStrategy::growTree(SearchTree& tree, const GameState& gs, unsigned int treeRollouts)
+	{
+		tree.root = std::make_unique<Node>(gs, false);
+		tree.nodes++;
+		tree.lowest = std::numeric_limits<float>::infinity();
+		tree.highest = -std::numeric_limits<float>::infinity();
+
+		// Reading the clock costs much less than a rollout: it is checked before each of them
+		// Every move of the coming polyomino is visited at least once, whatever the number of rollouts, for the decision not to be limited to the first moves listed
+		const std::vector<std::unique_ptr<Node>>& rootChildren(tree.root->children);
+		do
+		{
+			bool reachesGameOver(false);
+			visit(tree, *tree.root, reachesGameOver);
+			tree.rollouts++;
+		} while ((rollouts == 0 || tree.rollouts < treeRollouts || std::find(rootChildren.begin(), rootChildren.end(), nullptr) != rootChildren.end()) &&
+			!(hasDeadline && Clock::now() >= deadline));
+	}
+
+	float MonteCarloStrategy::visit(SearchTree& tree, Node& node, bool& reachesGameOver)
+	{
+		// A node reached by a move is first evaluated by a rollout: its moves or polyominos are only listed once it is visited again, so that leaves stay small
+		bool isLeaf(node.visits == 0 && node.isAfterMove);
+		if (!node.isTerminal && !isLeaf && node.children.empty())
+		{
+			if (node.state.polyominoQueueHead() != nullptr)
+			{
+				node.placements = node.state.getGrid().computePlacements(*node.state.polyominoQueueHead());
+				node.children.resize(node.placements.size());
+			}
+			else
+			{
+				node.children.resize(possiblePolyominos->size());
+			}
+			node.isTerminal = node.children.empty();
+		}
+
+		float value;
+		if (node.isTerminal)
+		{
+			reachesGameOver = node.state.isGameOver();
+			value = heuristic.evaluate(node.state);
+		}
+		else if (!isLeaf)
+		{
+			Node* child;
+			if (node.placements.empty())
+			{
+				// Polyominos are drawn as the game draws them: the child of each one is shared by the visits drawing it
+				unsigned int drawn(std::uniform_int_distribution<std::size_t>(0, possiblePolyominos->size() - 1)(tree.generator));
+				if (!node.children[drawn])
+				{
+					GameState state(node.state);
+					state.addPolyominoToQueue(&(*possiblePolyominos)[drawn]);
+					node.children[drawn] = std::make_unique<Node>(state, false);
+					tree.nodes++;
+				}
+				child = node.children[drawn].get();
+			}
+			else
+			{
+				unsigned int move(selectMove(tree, node));
+				if (!node.children[move])
+				{
+					GameState state(node.state);
+					state.play(node.placements[move]);
+					node.children[move] = std::make_unique<Node>(state, true);
+					tree.nodes++;
+				}
+				child = node.children[move].get();
+			}
+
+			value = visit(tree, *child, reachesGameOver);
+			if (node.isAfterMove)
+			{
+				value = heuristic.evaluateBranch(node.state, value);
+			}
+		}
+		else
+		{
+			value = rollout(tree, node, reachesGameOver);
+		}
+
+		node.visits++;
+		node.valueSum += value;
+		if (!reachesGameOver)
+		{
+			tree.lowest = std::min(tree.lowest, value);
+			tree.highest = std::max(tree.highest, value);
+		}
+		return value;
+	}
+
+	float MonteCarloStrategy::rollout(SearchTree& tree, const Node& node, bool& reachesGameOver)
+	{
+		std::vector<GameState>& states(tree.rolloutStates);
+		states.clear();
+		states.push_back(node.state);
+
+		float evaluation(0);
+		bool isEvaluated(false);
+		for (unsigned int move = 0; move < rolloutDepth && !states.back().isGameOver(); move++)
+		{
+			GameState state(states.back());
+			if (state.polyominoQueueHead() == nullptr)
+			{
+				if (possiblePolyominos->empty())
+				{
+					break;
+				}
+				state.addPolyominoToQueue(&(*possiblePolyominos)[std::uniform_int_distribution<std::size_t>(0, possiblePolyominos->size() - 1)(tree.generator)]);
+			}
+			std::vector<Placement> placements(state.getGrid().computePlacements(*state.polyominoQueueHead()));
+			if (placements.empty())
+			{
+				break;
+			}
+
+			// The move is the one a decision tree of depth 1 would choose: the first one best evaluated
+			int best(-1);
+			float bestEvaluation(0);
+			for (unsigned int p = 0; p < placements.size(); p++)
+			{
+				GameState postMoveState(state);
+				postMoveState.play(placements[p]);
+				float postMoveEvaluation(heuristic.evaluate(postMoveState));
+				if (best < 0 || postMoveEvaluation > bestEvaluation)
+				{
+					best = p;
+					bestEvaluation = postMoveEvaluation;
+				}
+			}
+			state.play(placements[best]);
+			states.push_back(state);
+			evaluation = bestEvaluation;
+			isEvaluated = true;
+		}
+
+		// As along a branch of a decision tree, each state of the path evaluates the branch below it
+		reachesGameOver = states.back().isGameOver();
+		if (!isEvaluated)
+		{
+			evaluation = heuristic.evaluate(states.back());
+		}
+		for (unsigned int i = states.size() - 1; i-- > 0;)
+		{
+			evaluation = heuristic.evaluateBranch(states[i], evaluation);
+		}
+		return evaluation;
+	}
+
+	unsigned int MonteCarloStrategy::selectMove(const SearchTree& tree, const Node& node) const
+	{
+		for (unsigned int m = 0; m < node.children.size(); m++)
+		{
+			if (!node.children[m])
+			{
+				return m;
+			}
+		}
+
+		float range(tree.highest - tree.lowest);
+		float logVisits(std::log(float(node.visits)));
+		unsigned int best(0);
+		float bestScore(-std::numeric_limits<float>::infinity());
+		for (unsigned int m = 0; m < node.children.size(); m++)
+		{
+			const Node& child(*node.children[m]);
+			float mean(float(child.valueSum / child.visits));
+			// Means below the lowest value come from game overs: they are as bad as the worst value
+			float normalized(range > 0 ? std::max(0.f, std::min(1.f, (mean - tree.lowest) / range)) : 0.5f);
+			float score(normalized + explorationConstant * std::sqrt(logVisits / child.visits));
+			if (score > bestScore)
+			{
+				best = m;
+				bestScore = score;
+			}
+		}
+		return best;
+	}
+
+}
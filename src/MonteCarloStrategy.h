@@ -0,0 +1,123 @@
+#ifndef TETRISAI_MONTECARLOSTRATEGY_H
+#define TETRISAI_MONTECARLOSTRATEGY_H
+
+#include <chrono>
+#include <memory>
+#include <random>
+#include <vector>
+#include "AIStrategy.h"
+#include "Heuristic.h"
+#include "ThreadPool.h"
+
+namespace TetrisAI {
+
+	/// <summary>
+	/// Strategy growing a Monte Carlo search tree from each game state: the most promising moves (UCT) are followed down the tree, the polyominos
+	/// that are not known yet being drawn uniformly as GameSequence::playGame does, and each new node is evaluated by a rollout playing greedily,
+	/// according to the heuristic, a number of moves further. The move chosen is the one visited the most.
+	///
+	/// Values are composed along the moves as in a decision tree (Heuristic::evaluateBranch). They are normalized by the lowest and highest
+	/// values seen in the tree, game overs excepted, for the exploration not to depend on the scale of the heuristic.
+	/// </summary>
+	/// <remarks>
+	/// With several threads, each of them grows its own tree from its own generator (root parallelization) and the visits of the moves of the
+	/// coming polyomino are summed over the trees: the trees share nothing while they are grown and, without a time budget, the decisions only
+	/// depend on the seed (the number of rollouts done within a time budget depends on the speed of the threads).
+	/// </remarks>
+	class MonteCarloStrategy : public AIStrategy {
+
+	public:
+		/// <summary>Largest number of moves played by a rollout</summary>
+		const static int maxDepth = 32;
+
+		/// <summary>Measures collected since the strategy was built</summary>
+		struct Statistics {
+			/// <summary>Number of rollouts, one per node visited from the root</summary>
+			unsigned long long rollouts;
+			/// <summary>Number of nodes added to the trees</summary>
+			unsigned long long treeNodes;
+		};
+
+		/// <param name="heuristic">Heuristic that should be used to evaluate the game states and to choose the moves of the rollouts</param>
+		/// <param name="rollouts">Number of rollouts per move, shared between the threads (0 to only stop when the time budget is spent), each tree doing at least one rollout per move of the coming polyomino unless the time budget is spent first</param>
+		/// <param name="rolloutDepth">Number of moves played by each rollout from the node it evaluates</param>
+		/// <param name="threads">Number of trees grown in parallel (the strategy then keeps a pool of threads for its whole life)</param>
+		/// <param name="timeBudget">Time after which no more rollout is started (zero to only stop after the given number of rollouts)</param>
+		/// <param name="seed">Seed of the generators drawing the polyominos that are not known yet</param>
+		/// <exception cred="std::invalid_argument">Thrown if rolloutDepth exceeds maxDepth, if threads is 0 or if neither rollouts nor timeBudget limits the search</exception>
+		MonteCarloStrategy(Heuristic& heuristic, unsigned int rollouts, unsigned int rolloutDepth, unsigned int threads = 1,
+			std::chrono::microseconds timeBudget = std::chrono::microseconds::zero(), unsigned int seed = 0);
+
+		/// <summary>Evaluate the possible outcomes from the given game state and outputs the best moves based on an heuristic</summary>
+		/// <param name="gs">Game state which should have at least one pending polyomino to be played</param>
+		/// <param name="possiblePolyominos">List of potential polyominos to draw the polyominos that are not known yet from</param>
+		virtual Transformation decideMove(const GameState& gs, std::vector<Polyomino>& possiblePolyominos);
+
+		Statistics getStatistics() const;
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		struct Node {
+			Node(const GameState& state, bool isAfterMove);
+
+			GameState state;
+			/// <summary>Whether the node was reached by a move (its value is then composed with Heuristic::evaluateBranch) or by drawing a polyomino</summary>
+			bool isAfterMove;
+			/// <summary>Whether the node has no child (game over, no move or no polyomino to draw): its value is then always the evaluation of its state</summary>
+			bool isTerminal;
+			unsigned int visits;
+			double valueSum;
+			/// <summary>Moves of the polyomino at the head of the queue (computed on the first visit, none if the next polyomino is not known)</summary>
+			std::vector<Placement> placements;
+			/// <summary>One child per placement or, if the next polyomino is not known, one per possible polyomino (nullptr until it is visited)</summary>
+			std::vector<std::unique_ptr<Node>> children;
+		};
+
+		/// <summary>Tree grown by a single thread</summary>
+		struct SearchTree {
+			SearchTree(unsigned int seed);
+
+			std::mt19937 generator;
+			std::unique_ptr<Node> root;
+			/// <summary>Lowest and highest values seen in the tree, game overs excepted</summary>
+			float lowest, highest;
+			unsigned long long rollouts, nodes;
+			/// <summary>States reached by the current rollout (kept from one rollout to another)</summary>
+			std::vector<GameState> rolloutStates;
+		};
+
+		Heuristic& heuristic;
+		unsigned int rollouts;
+		unsigned int rolloutDepth;
+		std::chrono::microseconds timeBudget;
+		Statistics statistics;
+		std::vector<SearchTree> trees;
+		/// <summary>Threads growing the trees when there are several of them (nullptr otherwise)</summary>
+		std::unique_ptr<ThreadPool> threadPool;
+
+		// Set for the duration of a decision
+		std::vector<Polyomino>* possiblePolyominos;
+		bool hasDeadline;
+		Clock::time_point deadline;
+
+		/// <summary>Grows a tree from the given game state until its rollouts are done and every move from the root is visited, or the deadline passes (at least one rollout is done)</summary>
+		void growTree(SearchTree& tree, const GameState& gs, unsigned int treeRollouts);
+
+		/// <summary>Follows the tree down from a node, adds a node and evaluates it, then updates the nodes on the way</summary>
+		/// <param name="reachesGameOver">Set to true if the value comes from a game over</param>
+		/// <returns>Value of the node for this visit</returns>
+		float visit(SearchTree& tree, Node& node, bool& reachesGameOver);
+
+		/// <summary>Plays rolloutDepth moves from the state of a node, choosing each move greedily with the heuristic</summary>
+		/// <param name="reachesGameOver">Set to true if the rollout ended on a game over</param>
+		/// <returns>Value of the node: the evaluation of the last state reached, composed along the moves played</returns>
+		float rollout(SearchTree& tree, const Node& node, bool& reachesGameOver);
+
+		/// <summary>Returns the index of the move to follow from a node: the first one never visited, if any, or the one with the best UCT score</summary>
+		unsigned int selectMove(const SearchTree& tree, const Node& node) const;
+	};
+
+}
+
+#endif
@@ -0,0 +1,216 @@
+#ifndef TETRISAI_NODEPOOL_H
+#define TETRISAI_NODEPOOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace TetrisAI {
+
+	/// <summary>
+	/// Allocator of the decision tree nodes of a given type, meant to back their class-specific operator new and delete.
+	///
+	/// Nodes are carved out of slabs of nodesPerSlab nodes that are only released at the end of the program: a freed node goes to
+	/// a free list of the calling thread and is handed out again by the next allocation of that thread, without any lock.
+	/// Threads that free much more than they allocate (e.g. the thread discarding the branches built by the others) give
+	/// their surplus back to a shared list in batches, and exiting threads give back all their free nodes.
+	/// The nodes in use are counted the same way: each thread reports its allocations and deallocations to a shared counter once they
+	/// add up to reportedNodes, so that counting does not make the threads contend on every node.
+	/// </summary>
+	/// <remarks>Allocations of another size than sizeof(Node) (e.g. from a class deriving from Node) are forwarded to the global operator new</remarks>
+	template <typename Node>
+	class NodePool {
+
+	public:
+		/// <summary>Number of nodes reserved at once, also the number of free nodes moved at once between a thread and the shared list</summary>
+		const static std::size_t nodesPerSlab = 256;
+		/// <summary>Number of allocations (or deallocations) a thread makes before reporting them to the count of the nodes in use</summary>
+		const static std::ptrdiff_t reportedNodes = 32;
+
+		static void* allocate(std::size_t size)
+		{
+			if (size != sizeof(Node))
+			{
+				return ::operator new(size);
+			}
+
+			LocalList& local(localList());
+			if (local.head == nullptr)
+			{
+				local.refill();
+			}
+			FreeNode* node(local.head);
+			local.head = node->next;
+			local.count--;
+			if (++local.unreported >= reportedNodes)
+			{
+				local.report();
+			}
+			return node;
+		}
+
+		static void deallocate(void* block, std::size_t size)
+		{
+			if (block == nullptr)
+			{
+				return;
+			}
+			if (size != sizeof(Node))
+			{
+				::operator delete(block);
+				return;
+			}
+
+			LocalList& local(localList());
+			FreeNode* node(static_cast<FreeNode*>(block));
+			node->next = local.head;
+			local.head = node;
+			local.count++;
+			if (--local.unreported <= -reportedNodes)
+			{
+				local.report();
+			}
+			if (local.count >= 2 * nodesPerSlab)
+			{
+				local.releaseBatch();
+			}
+		}
+
+		/// <summary>Returns the number of nodes the slabs can hold, whether they are in use or free</summary>
+		static std::size_t getReservedNodes()
+		{
+			SharedPool& shared(sharedPool());
+			std::lock_guard<std::mutex> lock(shared.mutex);
+			return shared.slabs.size() * nodesPerSlab;
+		}
+
+		/// <summary>Returns the number of nodes allocated and not freed yet, which may be off by reportedNodes per thread (the ones they did not report yet)</summary>
+		static std::size_t getNodesInUse()
+		{
+			std::ptrdiff_t nodes(sharedPool().nodesInUse.load(std::memory_order_relaxed));
+			return nodes > 0 ? nodes : 0;
+		}
+
+	private:
+		static_assert(sizeof(Node) >= sizeof(void*) && alignof(Node) <= alignof(std::max_align_t), "Nodes must be able to hold a free list link");
+
+		/// <summary>Link written over a node while it is free</summary>
+		struct FreeNode {
+			FreeNode* next;
+		};
+
+		/// <summary>Linked list of free nodes</summary>
+		struct Batch {
+			FreeNode* head;
+			std::size_t count;
+		};
+
+		struct SharedPool {
+			std::mutex mutex;
+			std::vector<void*> slabs;
+			/// <summary>Free nodes given back by the threads</summary>
+			std::vector<Batch> batches;
+			/// <summary>Nodes in use as reported by the threads (a node allocated by a thread and freed by another one is counted by both)</summary>
+			std::atomic<std::ptrdiff_t> nodesInUse;
+
+			SharedPool() : nodesInUse(0) {}
+
+			~SharedPool()
+			{
+				for (void* slab : slabs)
+				{
+					::operator delete(slab);
+				}
+			}
+		};
+
+		struct LocalList {
+			FreeNode* head;
+			std::size_t count;
+			/// <summary>Allocations minus deallocations of the thread since it last reported them</summary>
+			std::ptrdiff_t unreported;
+
+			// The shared pool is created first so that it outlives the lists of every thread
+			LocalList() : head(nullptr), count(0), unreported(0)
+			{
+				sharedPool();
+			}
+
+			~LocalList()
+			{
+				report();
+				if (head != nullptr)
+				{
+					SharedPool& shared(sharedPool());
+					std::lock_guard<std::mutex> lock(shared.mutex);
+					shared.batches.push_back(Batch{ head, count });
+				}
+			}
+
+			void report()
+			{
+				sharedPool().nodesInUse.fetch_add(unreported, std::memory_order_relaxed);
+				unreported = 0;
+			}
+
+			/// <summary>Takes a batch of the shared list or, if there is none, reserves a new slab</summary>
+			void refill()
+			{
+				SharedPool& shared(sharedPool());
+				std::lock_guard<std::mutex> lock(shared.mutex);
+				if (!shared.batches.empty())
+				{
+					head = shared.batches.back().head;
+					count = shared.batches.back().count;
+					shared.batches.pop_back();
+					return;
+				}
+
+				char* slab(static_cast<char*>(::operator new(nodesPerSlab * sizeof(Node))));
+				shared.slabs.push_back(slab);
+				for (std::size_t i = nodesPerSlab; i > 0; i--)
+				{
+					FreeNode* node(reinterpret_cast<FreeNode*>(slab + (i - 1) * sizeof(Node)));
+					node->next = head;
+					head = node;
+				}
+				count = nodesPerSlab;
+			}
+
+			/// <summary>Gives the first nodesPerSlab free nodes back to the shared list</summary>
+			void releaseBatch()
+			{
+				Batch batch{ head, nodesPerSlab };
+				FreeNode* last(head);
+				for (std::size_t i = 1; i < nodesPerSlab; i++)
+				{
+					last = last->next;
+				}
+				head = last->next;
+				last->next = nullptr;
+				count -= nodesPerSlab;
+
+				SharedPool& shared(sharedPool());
+				std::lock_guard<std::mutex> lock(shared.mutex);
+				shared.batches.push_back(batch);
+			}
+		};
+
+		static SharedPool& sharedPool()
+		{
+			static SharedPool shared;
+			return shared;
+		}
+
+		static LocalList& localList()
+		{
+			thread_local LocalList local;
+			return local;
+		}
+	};
+
+}
+
+#endif
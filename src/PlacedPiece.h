@@ -0,0 +1,30 @@
+#ifndef TETRISAI_PLACEDPIECE_H
+#define TETRISAI_PLACEDPIECE_H
+
+#include <array>
+#include "Row.h"
+#include "PolyominoCatalog.h"
+
+namespace TetrisAI {
+
+	/// <summary>Rotated polyomino translated to its columns in a grid row, precomputed once so that moves are played without copying nor shifting the piece</summary>
+	struct PlacedPiece {
+		/// <summary>Widest and highest rotated polyomino that can be placed</summary>
+		const static int maxSize = TETRISAI_MAX_SQUARES;
+
+		/// <summary>Rows of the piece shifted by the translation, from its bottom row to its top row (only the first height rows are used)</summary>
+		std::array<Row, maxSize> rows;
+		/// <summary>For each column of the piece (from right to left), the index of its lowest row containing a block</summary>
+		std::array<short, maxSize> bottomProfile;
+		/// <summary>For each column of the piece (from right to left), the index of its highest row containing a block</summary>
+		std::array<short, maxSize> topProfile;
+		short height;
+		short width;
+		short rotation;
+		/// <summary>Column where the rightmost column of the piece is</summary>
+		short translation;
+	};
+
+}
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef TETRISAI_PLACEMENT_H
+#define TETRISAI_PLACEMENT_H
+
+#include "Polyomino.h"
+#include "MoveResult.h"
+
+namespace TetrisAI {
+
+	/// <summary>Outcome of a legal transformation of a polyomino, computed without modifying the grid</summary>
+	struct Placement {
+		/// <summary>Transformation applied to the polyomino</summary>
+		Transformation transformation;
+		/// <summary>Index of the matching placed piece of the polyomino (see Polyomino::getPlacedPiece)</summary>
+		int placedPieceIndex;
+		/// <summary>Result that playing this transformation would produce (landing row, cleared lines, vanished blocks and game over)</summary>
+		MoveResult result;
+
+		Placement() : placedPieceIndex(-1) {}
+		Placement(Transformation transformation, int placedPieceIndex, MoveResult result) : transformation(transformation), placedPieceIndex(placedPieceIndex), result(result) {}
+	};
+
+}
+
+#endif
@@ -1,71 +1,118 @@
 #include "Polyomino.h"
 #include <stdexcept>
+#include <string>
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include "PolyominoEnumerator.h"
+#include "Utilities.h"
 
 namespace TetrisAI {
 
 	std::vector<Polyomino> Polyomino::getPolyominosList(unsigned int squares)
 	{
+		if (squares < 1 || squares > maxSquares)
+		{
+			throw std::invalid_argument("Unhandled case: can't generated polyomino list for a number of square greater than " + std::to_string(maxSquares) + ".");
+		}
+
 		std::vector<Polyomino> list;
-		switch (squares) {
-			case 1:
-				list.reserve(1);
-				list.push_back(Polyomino({ 1 }));
-				break;
-
-			case 2:
-				list.reserve(1);
-				list.push_back(Polyomino({ 3 }));
-				break;
-
-			case 3:
-				list.reserve(2);
-				list.push_back(Polyomino({ 7 }));
-				list.push_back(Polyomino({ 3, 1 }));
-				break;
-
-			case 4:
-				list.reserve(7);
-				list.push_back(Polyomino({ 2, 7 })); // T
-				list.push_back(Polyomino({ 15 })); // I
-				list.push_back(Polyomino({ 4, 7 })); // L
-				list.push_back(Polyomino({ 1, 7 })); // J
-				list.push_back(Polyomino({ 3, 3 })); // O
-				list.push_back(Polyomino({ 6, 3 })); // S
-				list.push_back(Polyomino({ 3, 6 })); // Z
-				break;
-
-			case 5:
-				// See https://upload.wikimedia.org/wikipedia/commons/thumb/a/aa/All_18_Pentominoes.svg/850px-All_18_Pentominoes.svg.png
-				// Elements created below are given in the same order as in the picture from left to right and top to bottom
-				list.reserve(18);
-				list.push_back(Polyomino({ 31 }));
-				list.push_back(Polyomino({ 2, 6, 3 }));
-				list.push_back(Polyomino({ 2, 3, 6 }));
-				list.push_back(Polyomino({ 3, 1, 1, 1 }));
-				list.push_back(Polyomino({ 3, 2, 2, 2 }));
-				list.push_back(Polyomino({ 1, 3, 3, 3 }));
-				list.push_back(Polyomino({ 2, 3, 3, 3 }));
-				list.push_back(Polyomino({ 2, 3, 1, 1 }));
-				list.push_back(Polyomino({ 1, 3, 2, 2 }));
-				list.push_back(Polyomino({ 2, 2, 7 }));
-				list.push_back(Polyomino({ 7, 5 }));
-				list.push_back(Polyomino({ 7, 1, 1 }));
-				list.push_back(Polyomino({ 6, 3, 1 }));
-				list.push_back(Polyomino({ 2, 7, 2 }));
-				list.push_back(Polyomino({ 1, 1, 3, 1 }));
-				list.push_back(Polyomino({ 2, 2, 3, 2 }));
-				list.push_back(Polyomino({ 6, 2, 3 }));
-				list.push_back(Polyomino({ 3, 2, 6 }));
-				break;
-
-			default:
-				throw std::invalid_argument("Unhandled case: can't generated polyomino list for a number of square greater than 4.");
+		list.reserve(getFirstId(squares + 1) - getFirstId(squares));
+		for (int id = getFirstId(squares); id < getFirstId(squares + 1); id++)
+		{
+			list.push_back(fromId(id));
+		}
+		return list;
+	}
+
+	const Polyomino& Polyomino::fromId(PolyominoId id)
+	{
+		// Built on first use only: every piece and its rotations come from the compile-time catalog
+		static const std::vector<Polyomino> catalog([]() {
+			std::vector<Polyomino> polyominos;
+			polyominos.reserve(PolyominoCatalog::size);
+			for (int id = 0; id < PolyominoCatalog::size; id++)
+			{
+				polyominos.push_back(Polyomino(id, PolyominoCatalog::entries[id]));
+			}
+			return polyominos;
+		}());
+
+		if (id < catalog.size())
+		{
+			return catalog[id];
+		}
+
+		for (int squares = PolyominoShape::maxSize + 1; squares <= maxSquares; squares++)
+		{
+			if (id < getFirstId(squares + 1))
+			{
+				return getEnumeratedPolyominos(squares)[id - getFirstId(squares)];
+			}
+		}
+		throw std::invalid_argument("The polyomino id " + std::to_string(id) + " does not match any polyomino.");
+	}
+
+	int Polyomino::getFirstId(unsigned int squares)
+	{
+		// Ids of enumerated polyominos follow the ones of the catalog, grouped by number of squares as well
+		static const std::array<int, maxSquares + 2> firstIds([]() {
+			std::array<int, maxSquares + 2> ids;
+			for (int size = 0; size <= maxSquares + 1; size++)
+			{
+				ids[size] = (size <= PolyominoShape::maxSize + 1) ? PolyominoCatalog::firstId(size) : ids[size - 1] + PolyominoEnumerator::getCount(size - 1);
+			}
+			return ids;
+		}());
+
+		if (squares > maxSquares + 1)
+		{
+			throw std::invalid_argument("Polyominos can't be composed of more than " + std::to_string(maxSquares) + " squares.");
+		}
+		return firstIds[squares];
+	}
+
+	void Polyomino::setCacheDirectory(const std::string& directory)
+	{
+		cacheDirectory() = directory;
+	}
+
+	std::string& Polyomino::cacheDirectory()
+	{
+		static std::string directory;
+		return directory;
+	}
+
+	const std::vector<Polyomino>& Polyomino::getEnumeratedPolyominos(unsigned int squares)
+	{
+		static std::array<std::vector<Polyomino>, maxSquares + 1> enumerated;
+		static std::array<std::once_flag, maxSquares + 1> enumeratedFlags;
+
+		// Several search threads may request the same pieces at once: only one of them enumerates them
+		std::call_once(enumeratedFlags[squares], [squares]() {
+			std::vector<std::vector<unsigned int>> baseContents(PolyominoEnumerator::load(squares, cacheDirectory()));
+			enumerated[squares].reserve(baseContents.size());
+			int id(getFirstId(squares));
+			for (auto& baseContent : baseContents)
+			{
+				enumerated[squares].push_back(Polyomino(id++, baseContent));
+			}
+		});
+		return enumerated[squares];
+	}
+
+	Polyomino::Polyomino(PolyominoId id, const PolyominoCatalogEntry& entry) : id(id)
+	{
+		for (int rotation = 0; rotation < entry.rotationCount; rotation++)
+		{
+			const PolyominoShape& shape(entry.rotations[rotation]);
+			rotatedPieces.push_back(PolyominoState(std::vector<unsigned int>(shape.rows, shape.rows + shape.height)));
 		}
 
-		return list;		
+		computePlacedPieces();
 	}
 
-	Polyomino::Polyomino(std::vector<unsigned int> baseContent)
+	Polyomino::Polyomino(PolyominoId id, const std::vector<unsigned int>& baseContent) : id(id)
 	{
 		// Stores the base state
 		rotatedPieces.push_back(PolyominoState(baseContent));
@@ -84,6 +131,68 @@ namespace TetrisAI {
 		{
 			throw std::invalid_argument("An error occurred while generating rotated versions of the polyomino.");
 		}
+
+		computePlacedPieces();
+	}
+
+	Polyomino::Polyomino(std::vector<unsigned int> baseContent) : Polyomino(fromId(findId(baseContent)))
+	{
+	}
+
+	PolyominoId Polyomino::findId(const std::vector<unsigned int>& baseContent)
+	{
+		int squares(0);
+		for (auto row : baseContent)
+		{
+			squares += activeBitsCount(row);
+		}
+
+		for (int id = getFirstId(squares > maxSquares ? maxSquares + 1 : squares); squares <= maxSquares && id < getFirstId(squares + 1); id++)
+		{
+			const std::vector<unsigned int>& base(fromId(id).getRotatedPiece(0).getContent());
+			if (baseContent == base)
+			{
+				return id;
+			}
+		}
+		throw std::invalid_argument("The polyomino is not in the catalog.");
+	}
+
+	PolyominoId Polyomino::getId() const
+	{
+		return id;
+	}
+
+	void Polyomino::computePlacedPieces()
+	{
+		for (unsigned rotation = 0; rotation < rotatedPieces.size(); rotation++)
+		{
+			const PolyominoState& piece(rotatedPieces[rotation]);
+			if (piece.getHeight() > PlacedPiece::maxSize || piece.getWidth() > PlacedPiece::maxSize)
+			{
+				throw std::invalid_argument("A polyomino can't exceed " + std::to_string(PlacedPiece::maxSize) + " blocks in width or height.");
+			}
+
+			rotationOffsets.push_back(placedPieces.size());
+			for (int translation = 0; translation <= rowBits - piece.getWidth(); translation++)
+			{
+				PlacedPiece placedPiece;
+				placedPiece.rows.fill(0);
+				placedPiece.bottomProfile.fill(-1);
+				placedPiece.topProfile.fill(-1);
+				for (int row = 0; row < piece.getHeight(); row++)
+				{
+					placedPiece.rows[row] = Row(piece.getContent()[row]) << translation;
+				}
+				std::copy(piece.getBottomProfile().begin(), piece.getBottomProfile().end(), placedPiece.bottomProfile.begin());
+				std::copy(piece.getTopProfile().begin(), piece.getTopProfile().end(), placedPiece.topProfile.begin());
+				placedPiece.height = piece.getHeight();
+				placedPiece.width = piece.getWidth();
+				placedPiece.rotation = rotation;
+				placedPiece.translation = translation;
+				placedPieces.push_back(placedPiece);
+			}
+		}
 	}
 
 	const PolyominoState& Polyomino::getRotatedPiece(int rotation) const
@@ -101,4 +210,24 @@ namespace TetrisAI {
 		return rotatedPieces.size();
 	}
 
+	int Polyomino::getPlacedPieceIndex(Transformation t) const
+	{
+		int rotation(t.rotation % rotatedPieces.size());
+		if (t.translation < 0 || t.translation > rowBits - rotatedPieces[rotation].getWidth())
+		{
+			return -1;
+		}
+		return rotationOffsets[rotation] + t.translation;
+	}
+
+	const PlacedPiece& Polyomino::getPlacedPiece(int index) const
+	{
+		return placedPieces[index];
+	}
+
+	int Polyomino::getPlacedPiecesCount() const
+	{
+		return placedPieces.size();
+	}
+
 }
\ No newline at end of file
@@ -2,7 +2,10 @@
 #define TETRISAI_POLYOMINO_H
 
 #include <vector>
+#include <string>
 #include "PolyominoState.h"
+#include "PlacedPiece.h"
+#include "PolyominoCatalog.h"
 
 namespace TetrisAI {
 
@@ -13,20 +16,38 @@ namespace TetrisAI {
 		Transformation() : translation(0), rotation(0) {}
 		Transformation(int t, int r) : translation(t), rotation(r) {}
 		Transformation(const Transformation & original) : translation(original.translation), rotation(original.rotation) {}
+		Transformation& operator=(const Transformation & original) = default;
 	};
 
 	class Polyomino {
 	public:
-		const static int maxSquares = 5;
+		const static int maxSquares = TETRISAI_MAX_SQUARES;
 
 		/// <summary>Helper to get the list of all possible Polyominos composed of a certain number of square</summary>
 		/// <param name="squares">Number of squares that should compose the polyominos</param>
+		/// <remarks>Polyominos of more than 5 squares are enumerated the first time they are requested (or read from the cache directory)</remarks>
 		static std::vector<Polyomino> getPolyominosList(unsigned int squares);
 
-		/// <summary>Instantiates a Polyomino based on one of its possible state</summary>
-		/// <param name="baseContent">Values defining a base piece on which the Polyomino and its rotation can be built</param>
+		/// <summary>Returns the Polyomino with the given id, built once and shared by the whole program</summary>
+		/// <exception cred="std::invalid_argument">Thrown if the id does not match any polyomino of 1 to maxSquares squares</exception>
+		static const Polyomino& fromId(PolyominoId id);
+
+		/// <summary>Returns the id of the first polyomino composed of a certain number of squares (ids are grouped by number of squares)</summary>
+		/// <param name="squares">Number of squares, from 1 to maxSquares + 1 (giving the number of ids)</param>
+		static int getFirstId(unsigned int squares);
+
+		/// <summary>Sets the directory where enumerated polyominos are cached so that later runs do not enumerate them again</summary>
+		/// <param name="directory">Existing directory (an empty string disables the cache, which is the default)</param>
+		/// <remarks>Must be called before any polyomino of more than 5 squares is used</remarks>
+		static void setCacheDirectory(const std::string& directory);
+
+		/// <summary>Instantiates the Polyomino of the catalog whose base state is the given content</summary>
+		/// <param name="baseContent">Values defining the base piece of a polyomino of the catalog</param>
+		/// <exception cred="std::invalid_argument">Thrown if no polyomino of the catalog has that base state</exception>
 		Polyomino(std::vector<unsigned int> baseContent);
 
+		PolyominoId getId() const;
+
 		/// <summary>Retrieve a substate of the Polyomino corresponding to a certain number of rotations</summary>
 		const PolyominoState& getRotatedPiece(int rotation) const;
 
@@ -34,9 +55,41 @@ namespace TetrisAI {
 		const std::vector<unsigned int> getTransformedPiece(Transformation t) const;
 		int getRotationCount() const;
 
+		/// <summary>Returns the index of the placed piece matching a transformation, or -1 if the translation does not fit in any grid</summary>
+		/// <remarks>Whether the piece fits in a given grid must still be checked against its width</remarks>
+		int getPlacedPieceIndex(Transformation t) const;
+		/// <summary>Retrieve a placed piece from its index (see getPlacedPieceIndex)</summary>
+		const PlacedPiece& getPlacedPiece(int index) const;
+		int getPlacedPiecesCount() const;
+
 	private:
+		/// <summary>Instantiates a Polyomino of the catalog, its rotations being read from the compile-time tables</summary>
+		/// <param name="id">Index of the polyomino in the catalog</param>
+		/// <param name="entry">Catalog entry of the polyomino</param>
+		Polyomino(PolyominoId id, const PolyominoCatalogEntry& entry);
+
+		/// <summary>Instantiates an enumerated Polyomino, its rotations being computed from its base state</summary>
+		/// <param name="id">Id of the polyomino</param>
+		/// <param name="baseContent">Values defining the base piece on which the Polyomino and its rotation are built</param>
+		Polyomino(PolyominoId id, const std::vector<unsigned int>& baseContent);
+
+		PolyominoId id;
 		/// <summary>Stores all sub states of the polyomino: one for each possible rotation</summary>
 		std::vector<PolyominoState> rotatedPieces;
+		/// <summary>Every (rotation, translation) of the polyomino fitting in the widest grid, ordered by rotation then translation</summary>
+		std::vector<PlacedPiece> placedPieces;
+		/// <summary>Index of the first placed piece of each rotation</summary>
+		std::vector<int> rotationOffsets;
+
+		void computePlacedPieces();
+
+		/// <summary>Returns the id of the polyomino whose base state is the given content</summary>
+		static PolyominoId findId(const std::vector<unsigned int>& baseContent);
+
+		/// <summary>Returns the polyominos of more than 5 squares, enumerated on first use</summary>
+		static const std::vector<Polyomino>& getEnumeratedPolyominos(unsigned int squares);
+
+		static std::string& cacheDirectory();
 	};
 }
 
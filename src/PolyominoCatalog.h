@@ -0,0 +1,201 @@
+#ifndef TETRISAI_POLYOMINOCATALOG_H
+#define TETRISAI_POLYOMINOCATALOG_H
+
+#include <cstdint>
+#include <limits>
+
+// Largest number of squares of the polyominos, chosen at build time through the TETRISAI_MAX_SQUARES CMake option (5 to 8)
+// Polyominos of up to 5 squares are listed below, larger ones are enumerated when first used (see PolyominoEnumerator)
+#ifndef TETRISAI_MAX_SQUARES
+#define TETRISAI_MAX_SQUARES 7
+#endif
+
+#if TETRISAI_MAX_SQUARES < 5 || TETRISAI_MAX_SQUARES > 8
+#error "TETRISAI_MAX_SQUARES must be between 5 and 8"
+#endif
+
+namespace TetrisAI {
+
+	/// <summary>Index of a polyomino among all the polyominos of 1 to TETRISAI_MAX_SQUARES squares, identifying it whatever the list or the copy it is taken from</summary>
+	typedef std::uint16_t PolyominoId;
+
+	/// <summary>Raw content of a rotated polyomino usable in constant expressions</summary>
+	struct PolyominoShape {
+		/// <summary>Widest and highest shape of the compile-time catalog</summary>
+		const static int maxSize = 5;
+
+		/// <summary>Rows of the shape from its bottom row to its top row (only the first height rows are used)</summary>
+		unsigned int rows[maxSize];
+		int height;
+		int width;
+	};
+
+	/// <summary>Polyomino of the catalog along with all its distinct rotations</summary>
+	struct PolyominoCatalogEntry {
+		/// <summary>Number of squares composing the polyomino</summary>
+		int squares;
+		/// <summary>Clockwise rotations of the base shape (only the first rotationCount ones are used)</summary>
+		PolyominoShape rotations[4];
+		int rotationCount;
+	};
+
+	namespace PolyominoCatalog {
+
+		/// <summary>Builds a shape from its rows (from bottom to top), the first empty row ending the shape</summary>
+		constexpr PolyominoShape makeShape(unsigned int r0, unsigned int r1 = 0, unsigned int r2 = 0, unsigned int r3 = 0, unsigned int r4 = 0)
+		{
+			PolyominoShape shape{};
+			unsigned int rows[PolyominoShape::maxSize] = { r0, r1, r2, r3, r4 };
+			for (int row = 0; row < PolyominoShape::maxSize && rows[row]; row++)
+			{
+				shape.rows[row] = rows[row];
+				shape.height++;
+				int width(0);
+				for (unsigned int value = rows[row]; value; value >>= 1)
+				{
+					width++;
+				}
+				shape.width = width > shape.width ? width : shape.width;
+			}
+			return shape;
+		}
+
+		/// <summary>Performs a clockwise 90 degrees rotation of a shape (same result as PolyominoState::getRotatedState)</summary>
+		constexpr PolyominoShape rotateShape(const PolyominoShape& shape)
+		{
+			// Block (row, col) moves to (col, height - 1 - row): the shape is transposed then each row is mirrored
+			PolyominoShape rotated{};
+			rotated.height = shape.width;
+			rotated.width = shape.height;
+			for (int row = 0; row < shape.height; row++)
+			{
+				for (int col = 0; col < shape.width; col++)
+				{
+					if (shape.rows[row] & (1u << col))
+					{
+						rotated.rows[col] |= 1u << (shape.height - 1 - row);
+					}
+				}
+			}
+			return rotated;
+		}
+
+		constexpr bool shapesEqual(const PolyominoShape& a, const PolyominoShape& b)
+		{
+			if (a.height != b.height || a.width != b.width)
+			{
+				return false;
+			}
+			for (int row = 0; row < a.height; row++)
+			{
+				if (a.rows[row] != b.rows[row])
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/// <summary>Builds a catalog entry by rotating the base shape until it is found again</summary>
+		constexpr PolyominoCatalogEntry makeEntry(int squares, const PolyominoShape& base)
+		{
+			PolyominoCatalogEntry entry{};
+			entry.squares = squares;
+			entry.rotations[0] = base;
+			entry.rotationCount = 1;
+			for (PolyominoShape rotated = rotateShape(base); !shapesEqual(rotated, base) && entry.rotationCount < 4; rotated = rotateShape(rotated))
+			{
+				entry.rotations[entry.rotationCount++] = rotated;
+			}
+			return entry;
+		}
+
+		/// <summary>Every polyomino of 1 to 5 squares, grouped by number of squares (their index is their PolyominoId, larger polyominos come next)</summary>
+		constexpr PolyominoCatalogEntry entries[] = {
+			makeEntry(1, makeShape(1)),
+
+			makeEntry(2, makeShape(3)),
+
+			makeEntry(3, makeShape(7)),
+			makeEntry(3, makeShape(3, 1)),
+
+			makeEntry(4, makeShape(2, 7)), // T
+			makeEntry(4, makeShape(15)), // I
+			makeEntry(4, makeShape(4, 7)), // L
+			makeEntry(4, makeShape(1, 7)), // J
+			makeEntry(4, makeShape(3, 3)), // O
+			makeEntry(4, makeShape(6, 3)), // S
+			makeEntry(4, makeShape(3, 6)), // Z
+
+			// See https://upload.wikimedia.org/wikipedia/commons/thumb/a/aa/All_18_Pentominoes.svg/850px-All_18_Pentominoes.svg.png
+			// Elements are given in the same order as in the picture from left to right and top to bottom
+			makeEntry(5, makeShape(31)),
+			makeEntry(5, makeShape(2, 6, 3)),
+			makeEntry(5, makeShape(2, 3, 6)),
+			makeEntry(5, makeShape(3, 1, 1, 1)),
+			makeEntry(5, makeShape(3, 2, 2, 2)),
+			makeEntry(5, makeShape(1, 3, 3)),
+			makeEntry(5, makeShape(2, 3, 3)),
+			makeEntry(5, makeShape(2, 3, 1, 1)),
+			makeEntry(5, makeShape(1, 3, 2, 2)),
+			makeEntry(5, makeShape(2, 2, 7)),
+			makeEntry(5, makeShape(7, 5)),
+			makeEntry(5, makeShape(7, 1, 1)),
+			makeEntry(5, makeShape(6, 3, 1)),
+			makeEntry(5, makeShape(2, 7, 2)),
+			makeEntry(5, makeShape(1, 1, 3, 1)),
+			makeEntry(5, makeShape(2, 2, 3, 2)),
+			makeEntry(5, makeShape(6, 2, 3)),
+			makeEntry(5, makeShape(3, 2, 6))
+		};
+
+		constexpr int size = sizeof(entries) / sizeof(entries[0]);
+
+		/// <summary>Returns the id of the first polyomino composed of a certain number of squares (or size if there is none)</summary>
+		constexpr int firstId(int squares)
+		{
+			int id(0);
+			while (id < size && entries[id].squares < squares)
+			{
+				id++;
+			}
+			return id;
+		}
+
+		/// <summary>Returns the number of polyominos composed of a certain number of squares</summary>
+		constexpr int count(int squares)
+		{
+			return firstId(squares + 1) - firstId(squares);
+		}
+
+		/// <summary>Returns true if every entry of the catalog is made of the number of squares it is listed with</summary>
+		constexpr bool squaresMatch()
+		{
+			for (int id = 0; id < size; id++)
+			{
+				int squares(0);
+				for (int row = 0; row < entries[id].rotations[0].height; row++)
+				{
+					for (unsigned int value = entries[id].rotations[0].rows[row]; value; value >>= 1)
+					{
+						squares += value & 1;
+					}
+				}
+				if (squares != entries[id].squares)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		static_assert(squaresMatch(), "A polyomino of the catalog is not made of the number of squares it is listed with");
+		static_assert(size <= std::numeric_limits<PolyominoId>::max(), "Polyomino ids must fit in a PolyominoId");
+		static_assert(count(3) == 2 && count(4) == 7 && count(5) == 18, "Unexpected number of polyominos in the catalog");
+		static_assert(entries[firstId(4)].rotationCount == 4 && entries[firstId(4) + 1].rotationCount == 2 && entries[firstId(4) + 4].rotationCount == 1,
+			"Unexpected rotations of the T, I and O tetrominos");
+	}
+
+}
+
+#endif
@@ -0,0 +1,267 @@
+#include "PolyominoEnumerator.h"
+#include <set>
+#include <algorithm>
+#include <fstream>
+#include <cstdint>
+#include <stdexcept>
+#include "Utilities.h"
+#include "BitKernels.h"
+
+namespace TetrisAI {
+
+	namespace {
+
+		/// <summary>Rows of a polyomino packed in a single word: row r (from the bottom) is stored in byte r, its rightmost block in the lowest bit</summary>
+		typedef std::uint64_t ShapeKey;
+
+		/// <summary>Number of one-sided polyominos of n squares (OEIS A000988), used to validate the enumeration and the cache files</summary>
+		const int oneSidedCounts[PolyominoEnumerator::maxSquares + 1] = { 0, 1, 1, 2, 7, 18, 60, 196, 704 };
+
+		/// <summary>First bytes of a cache file, followed by the format version</summary>
+		const char cacheMagic[4] = { 'T', 'A', 'I', 'P' };
+		const char cacheVersion = 1;
+
+		std::vector<unsigned int> unpack(ShapeKey key)
+		{
+			std::vector<unsigned int> rows;
+			for (; key; key >>= 8)
+			{
+				rows.push_back(key & 0xFF);
+			}
+			return rows;
+		}
+
+		ShapeKey pack(const std::vector<unsigned int>& rows)
+		{
+			ShapeKey key(0);
+			for (unsigned row = 0; row < rows.size(); row++)
+			{
+				key |= ShapeKey(rows[row]) << (8 * row);
+			}
+			return key;
+		}
+
+		int shapeWidth(const std::vector<unsigned int>& rows)
+		{
+			unsigned int allColumns(0);
+			for (auto row : rows)
+			{
+				allColumns |= row;
+			}
+			return bitLength(allColumns);
+		}
+
+		/// <summary>Clockwise 90 degrees rotation, identical to PolyominoState::getRotatedState</summary>
+		std::vector<unsigned int> rotate(const std::vector<unsigned int>& rows)
+		{
+			int height(rows.size());
+			std::vector<unsigned int> rotated(shapeWidth(rows), 0);
+			for (int row = 0; row < height; row++)
+			{
+				for (unsigned col = 0; col < rotated.size(); col++)
+				{
+					if (rows[row] & (1u << col))
+					{
+						rotated[col] |= 1u << (height - 1 - row);
+					}
+				}
+			}
+			return rotated;
+		}
+
+		/// <summary>Returns the smallest key among the rotations of a shape</summary>
+		ShapeKey canonicalKey(const std::vector<unsigned int>& rows)
+		{
+			ShapeKey best(pack(rows));
+			std::vector<unsigned int> rotated(rows);
+			for (int rotation = 1; rotation < 4; rotation++)
+			{
+				rotated = rotate(rotated);
+				ShapeKey key(pack(rotated));
+				best = key < best ? key : best;
+			}
+			return best;
+		}
+
+		void checkSquares(int squares)
+		{
+			if (squares < 1 || squares > PolyominoEnumerator::maxSquares)
+			{
+				throw std::invalid_argument("Polyominos can only be enumerated from 1 to " + std::to_string(PolyominoEnumerator::maxSquares) + " squares.");
+			}
+		}
+	}
+
+	int PolyominoEnumerator::getCount(int squares)
+	{
+		checkSquares(squares);
+		return oneSidedCounts[squares];
+	}
+
+	std::vector<std::vector<unsigned int>> PolyominoEnumerator::enumerate(int squares)
+	{
+		checkSquares(squares);
+
+		std::set<ShapeKey> shapes({ 1 }); // The monomino
+		for (int size = 2; size <= squares; size++)
+		{
+			std::set<ShapeKey> grownShapes;
+			for (ShapeKey key : shapes)
+			{
+				// The shape is moved one block up and left so that a square can be added on each of its sides
+				std::vector<unsigned int> rows(unpack(key)), margined(rows.size() + 2, 0);
+				for (unsigned row = 0; row < rows.size(); row++)
+				{
+					margined[row + 1] = rows[row] << 1;
+				}
+
+				int width(shapeWidth(rows) + 2);
+				for (int row = 0; row < (int)margined.size(); row++)
+				{
+					for (int col = 0; col < width; col++)
+					{
+						unsigned int block(1u << col);
+						bool isEmpty(!(margined[row] & block));
+						bool touchesShape((row > 0 && (margined[row - 1] & block)) || (row + 1 < (int)margined.size() && (margined[row + 1] & block)) ||
+							(margined[row] & (block << 1)) || (margined[row] & (block >> 1)));
+						if (!isEmpty || !touchesShape)
+						{
+							continue;
+						}
+
+						// Add the square then remove the empty margins left
+						std::vector<unsigned int> grown(margined);
+						grown[row] |= block;
+						if (!grown.back())
+						{
+							grown.pop_back();
+						}
+						if (!grown.front())
+						{
+							grown.erase(grown.begin());
+						}
+						unsigned int allColumns(0);
+						for (auto value : grown)
+						{
+							allColumns |= value;
+						}
+						if (!(allColumns & 1))
+						{
+							for (auto& value : grown)
+							{
+								value >>= 1;
+							}
+						}
+
+						grownShapes.insert(canonicalKey(grown));
+					}
+				}
+			}
+			shapes.swap(grownShapes);
+		}
+
+		if ((int)shapes.size() != oneSidedCounts[squares])
+		{
+			throw std::runtime_error("The enumeration of polyominos of " + std::to_string(squares) + " squares did not give the expected count.");
+		}
+
+		std::vector<std::vector<unsigned int>> polyominos;
+		polyominos.reserve(shapes.size());
+		for (ShapeKey key : shapes)
+		{
+			polyominos.push_back(unpack(key));
+		}
+		return polyominos;
+	}
+
+	std::vector<std::vector<unsigned int>> PolyominoEnumerator::load(int squares, const std::string& cacheDirectory)
+	{
+		checkSquares(squares);
+
+		std::vector<std::vector<unsigned int>> polyominos;
+		if (cacheDirectory.empty())
+		{
+			return enumerate(squares);
+		}
+
+		std::string path(getCachePath(squares, cacheDirectory));
+		if (!readCache(path, squares, polyominos))
+		{
+			polyominos = enumerate(squares);
+			writeCache(path, squares, polyominos);
+		}
+		return polyominos;
+	}
+
+	std::string PolyominoEnumerator::getCachePath(int squares, const std::string& cacheDirectory)
+	{
+		return cacheDirectory + "/polyominos" + std::to_string(squares) + ".bin";
+	}
+
+	bool PolyominoEnumerator::readCache(const std::string& path, int squares, std::vector<std::vector<unsigned int>>& polyominos)
+	{
+		// Format: magic, version, number of squares, number of polyominos (2 bytes, little endian)
+		// then, for each polyomino, its height followed by one byte per row (from the bottom)
+		std::ifstream file(path, std::ios::binary);
+		char header[8];
+		if (!file.read(header, sizeof(header)) || !std::equal(cacheMagic, cacheMagic + 4, header) || header[4] != cacheVersion || header[5] != squares)
+		{
+			return false;
+		}
+
+		int count((unsigned char)header[6] | ((unsigned char)header[7] << 8));
+		if (count != oneSidedCounts[squares])
+		{
+			return false;
+		}
+
+		std::vector<std::vector<unsigned int>> readPolyominos;
+		readPolyominos.reserve(count);
+		std::set<ShapeKey> keys;
+		for (int index = 0; index < count; index++)
+		{
+			char height, rows[maxSquares];
+			if (!file.get(height) || height < 1 || height > squares || !file.read(rows, height))
+			{
+				return false;
+			}
+
+			// Every polyomino must be made of the right number of squares and appear once
+			std::vector<unsigned int> polyomino(rows, rows + height);
+			int blocks(0);
+			bool hasEmptyRow(false);
+			for (auto& row : polyomino)
+			{
+				row &= 0xFF;
+				blocks += activeBitsCount(row);
+				hasEmptyRow = hasEmptyRow || !row;
+			}
+			if (blocks != squares || hasEmptyRow || !keys.insert(canonicalKey(polyomino)).second)
+			{
+				return false;
+			}
+			readPolyominos.push_back(polyomino);
+		}
+
+		polyominos.swap(readPolyominos);
+		return true;
+	}
+
+	void PolyominoEnumerator::writeCache(const std::string& path, int squares, const std::vector<std::vector<unsigned int>>& polyominos)
+	{
+		// Failing to write the cache only means that the polyominos will be enumerated again next time
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		char header[8] = { cacheMagic[0], cacheMagic[1], cacheMagic[2], cacheMagic[3], cacheVersion, (char)squares,
+			(char)(polyominos.size() & 0xFF), (char)(polyominos.size() >> 8) };
+		file.write(header, sizeof(header));
+		for (auto& polyomino : polyominos)
+		{
+			file.put((char)polyomino.size());
+			for (auto row : polyomino)
+			{
+				file.put((char)row);
+			}
+		}
+	}
+
+}
@@ -0,0 +1,49 @@
+#ifndef TETRISAI_POLYOMINOENUMERATOR_H
+#define TETRISAI_POLYOMINOENUMERATOR_H
+
+#include <vector>
+#include <string>
+
+namespace TetrisAI {
+
+	/// <summary>
+	/// Generates the one-sided polyominos composed of a given number of squares: pieces that only differ by a rotation are the same
+	/// while mirrored pieces are distinct (as L and J, or S and Z, in the tetrominos list).
+	///
+	/// Polyominos of n squares are obtained by adding a square next to each polyomino of n-1 squares and keeping only one
+	/// rotation of each shape found: its canonical form, the rotation whose rows give the smallest key.
+	/// </summary>
+	class PolyominoEnumerator {
+
+	public:
+		/// <summary>Largest number of squares that can be enumerated (a polyomino is then stored in 8 rows of 8 bits)</summary>
+		const static int maxSquares = 8;
+
+		/// <summary>Returns the number of one-sided polyominos composed of a certain number of squares</summary>
+		/// <exception cred="std::invalid_argument">Thrown if the number of squares is out of [1, maxSquares]</exception>
+		static int getCount(int squares);
+
+		/// <summary>Enumerates the one-sided polyominos composed of a certain number of squares</summary>
+		/// <param name="squares">Number of squares composing each polyomino</param>
+		/// <returns>The canonical form of each polyomino (rows from bottom to top), sorted by key</returns>
+		/// <exception cred="std::invalid_argument">Thrown if the number of squares is out of [1, maxSquares]</exception>
+		static std::vector<std::vector<unsigned int>> enumerate(int squares);
+
+		/// <summary>Reads the polyominos from a cache file of the given directory, or enumerates them and writes that cache file</summary>
+		/// <param name="squares">Number of squares composing each polyomino</param>
+		/// <param name="cacheDirectory">Directory holding the cache files (an empty string disables the cache)</param>
+		/// <returns>The same list as enumerate</returns>
+		/// <remarks>A missing, unreadable or inconsistent cache file is simply replaced</remarks>
+		static std::vector<std::vector<unsigned int>> load(int squares, const std::string& cacheDirectory);
+
+		/// <summary>Returns the path of the cache file storing the polyominos of a certain number of squares</summary>
+		static std::string getCachePath(int squares, const std::string& cacheDirectory);
+
+	private:
+		static bool readCache(const std::string& path, int squares, std::vector<std::vector<unsigned int>>& polyominos);
+		static void writeCache(const std::string& path, int squares, const std::vector<std::vector<unsigned int>>& polyominos);
+	};
+
+}
+
+#endif
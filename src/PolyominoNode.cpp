@@ -1,22 +1,52 @@
 #include "PolyominoNode.h"
+#include "NodePool.h"
+#include "TranspositionTable.h"
+#include <stdexcept>
 
 namespace TetrisAI {
 
-	PolyominoNode::PolyominoNode(GameState& gameState, Polyomino* p, int depth, std::vector<Polyomino>& possiblePolyominos, Heuristic& heuristic) : polyomino(p)
+	PolyominoNode::PolyominoNode(GameState& gameState, const Polyomino* p, int depth, std::vector<Polyomino>& possiblePolyominos, Heuristic& heuristic) :
+		PolyominoNode(gameState, p, depth, SearchContext(possiblePolyominos, heuristic))
+	{
+	}
+
+	PolyominoNode::PolyominoNode(GameState& gameState, const Polyomino* p, int depth, const SearchContext& context, float weight, bool useMultithreading) : polyomino(p), weight(weight)
 	{
 		GameState subGameState = gameState; // copy
 		subGameState.addPolyominoToQueue(p);
-		subRoot = std::make_unique<GameStateNode>(subGameState, depth, possiblePolyominos, heuristic);
+
+		// If the subtree of the sub root was already evaluated elsewhere, its evaluation is reused instead of building it (the sub root still
+		// evaluates its branch itself, since it depends on the move that led to it)
+		float childrenEvaluation;
+		if (context.transpositionTable != nullptr && depth > 0 && !subGameState.isGameOver() &&
+			context.transpositionTable->probe(subGameState.getHash(), depth, childrenEvaluation))
+		{
+			subRoot = std::make_unique<GameStateNode>(subGameState, childrenEvaluation, context.heuristic);
+		}
+		else
+		{
+			subRoot = std::make_unique<GameStateNode>(subGameState, depth, context, useMultithreading);
+		}
+	}
+
+	void* PolyominoNode::operator new(std::size_t size)
+	{
+		return NodePool<PolyominoNode>::allocate(size);
 	}
 
-	void PolyominoNode::updateTree(Polyomino* newPolyomino, int depth, std::vector<Polyomino>& possiblePolyominos, Heuristic& heuristic, bool useMultithreading)
+	void PolyominoNode::operator delete(void* block, std::size_t size)
+	{
+		NodePool<PolyominoNode>::deallocate(block, size);
+	}
+
+	void PolyominoNode::updateTree(const Polyomino* newPolyomino, int depth, const SearchContext& context, bool useMultithreading)
 	{
 		if (newPolyomino != nullptr)
 		{
 			throw std::invalid_argument("Error: PolyominoNode::updateTree should not receive newPolyominos since they represent cases where the polyomino is unknown.");
 		}
 
-		subRoot->updateTree(newPolyomino, depth, possiblePolyominos, heuristic, useMultithreading);
+		subRoot->updateTree(newPolyomino, depth, context, useMultithreading);
 	}
 
 	void PolyominoNode::movingChildrenOwnership(std::vector<std::unique_ptr<DecisionTreeNode>>& destination)
@@ -24,14 +54,20 @@ namespace TetrisAI {
 		subRoot->movingChildrenOwnership(destination);
 	}
 
+	bool PolyominoNode::collapse()
+	{
+		return subRoot->collapse();
+	}
+
 	std::unique_ptr<DecisionTreeNode> PolyominoNode::extractBestChild()
 	{
 		return subRoot->extractBestChild();
 	}
 
-	bool PolyominoNode::matchPolyomino(Polyomino* p)
+	bool PolyominoNode::matchPolyomino(const Polyomino* p)
 	{
-		return p == polyomino;
+		// Polyominos are compared by id: the game state hands out the pieces of the catalog rather than the ones of the possible polyominos list
+		return p->getId() == polyomino->getId();
 	}
 
 	DecisionTreeNode::NodeStatus PolyominoNode::getNodeStatus()
@@ -60,11 +96,15 @@ namespace TetrisAI {
 		return subRoot->isGameOver();
 	}
 
-	// Compute a mean in an iterative way
-	// X(t) = (t-1)/t * X(t-1) + x(t)/t  = [(t-1) * X(t-1) + x(t)]/t
-	float PolyominoNode::computeSiblingsEvaluation(float currentEvaluation, unsigned nodePosition)
+	// Compute a weighted mean in an iterative way
+	// X(t) = [W(t-1) * X(t-1) + w(t) * x(t)] / [W(t-1) + w(t)], which is [(t-1) * X(t-1) + x(t)]/t when every weight is 1
+	float PolyominoNode::computeSiblingsEvaluation(float currentEvaluation, float siblingsWeight)
+	{
+		return (siblingsWeight * currentEvaluation + weight * getNodeEvaluation()) / (siblingsWeight + weight);
+	}
+
+	float PolyominoNode::getSiblingWeight() const
 	{
-		// Implicit conversion of nodePosition to float ensures correct computation
-		return (nodePosition * currentEvaluation + getNodeEvaluation()) / (nodePosition + 1);
+		return weight;
 	}
 }
\ No newline at end of file
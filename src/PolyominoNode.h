@@ -17,22 +17,35 @@ namespace TetrisAI {
 	class PolyominoNode : public DecisionTreeNode {
 
 	public:
-		PolyominoNode(GameState& gameState, Polyomino* p, int depth, std::vector<Polyomino>& possiblePolyominos, Heuristic& heuristic);
-		virtual void updateTree(Polyomino* newPolyomino, int depth, std::vector<Polyomino>& possiblePolyominos, Heuristic& heuristic, bool useMultithreading);
+		using DecisionTreeNode::updateTree;
+
+		PolyominoNode(GameState& gameState, const Polyomino* p, int depth, std::vector<Polyomino>& possiblePolyominos, Heuristic& heuristic);
+		/// <param name="weight">Number of possible polyominos the node stands for when only a sample of them is expanded</param>
+		/// <param name="useMultithreading">Whether the subtree is built by the threads of the thread pool of the context</param>
+		PolyominoNode(GameState& gameState, const Polyomino* p, int depth, const SearchContext& context, float weight = 1, bool useMultithreading = false);
+		/// <summary>Nodes are allocated from a NodePool: building and discarding branches does not go through the global heap</summary>
+		static void* operator new(std::size_t size);
+		static void operator delete(void* block, std::size_t size);
+
+		virtual void updateTree(const Polyomino* newPolyomino, int depth, const SearchContext& context, bool useMultithreading);
 		virtual void movingChildrenOwnership(std::vector<std::unique_ptr<DecisionTreeNode>>& destination);
+		virtual bool collapse();
 		virtual std::unique_ptr<DecisionTreeNode> extractBestChild();
-		virtual bool matchPolyomino(Polyomino* polyomino);
+		virtual bool matchPolyomino(const Polyomino* polyomino);
 		virtual NodeStatus getNodeStatus();
 		virtual float getNodeEvaluation() const;
 		virtual Transformation getPolyominoMove() const;
 		virtual bool isGameOver() const;
-		virtual float computeSiblingsEvaluation(float currentEvaluation, unsigned nodePosition);
+		virtual float computeSiblingsEvaluation(float currentEvaluation, float siblingsWeight);
+		virtual float getSiblingWeight() const;
 
 	private:
 		/// <summary>Polyomino that is considered for this node and its children</summary>
-		Polyomino* polyomino;
+		const Polyomino* polyomino;
 		/// <summary>Sub decision tree based on the case where the next polyomino is the one referenced in this instance</summary>
 		std::unique_ptr<GameStateNode> subRoot;
+		/// <summary>Weight of the node in the mean of its siblings</summary>
+		float weight;
 	};
 
 }
@@ -13,6 +13,7 @@ namespace TetrisAI {
 			}
 		}
 		computeWidth(); 
+		computeProfiles();
 	}
 	
 	std::vector<unsigned int> PolyominoState::getTranslatedState(int translation) const
@@ -35,11 +36,17 @@ namespace TetrisAI {
 		return width;
 	}
 
+	const std::vector<unsigned int>& PolyominoState::getContent() const
+	{
+		return content;
+	}
+
 	PolyominoState PolyominoState::getRotatedState()
 	{
 		PolyominoState copy = *this;
 		copy.transpose();
 		copy.reverseLines();
+		copy.computeProfiles();
 		return copy;
 	}
 
@@ -57,6 +64,34 @@ namespace TetrisAI {
 		}
 	}
 
+	const std::vector<short>& PolyominoState::getBottomProfile() const
+	{
+		return bottomProfile;
+	}
+
+	const std::vector<short>& PolyominoState::getTopProfile() const
+	{
+		return topProfile;
+	}
+
+	void PolyominoState::computeProfiles()
+	{
+		bottomProfile = std::vector<short>(getWidth(), -1);
+		topProfile = std::vector<short>(getWidth(), -1);
+		for (int row = 0; row < getHeight(); row++)
+		{
+			for (int col = 0; col < getWidth(); col++)
+			{
+				if (content[row] & (1 << col))
+				{
+					// Rows are browsed from the bottom: the first block found is the lowest, the last one is the highest
+					bottomProfile[col] = (bottomProfile[col] == -1) ? row : bottomProfile[col];
+					topProfile[col] = row;
+				}
+			}
+		}
+	}
+
 	void PolyominoState::transpose()
 	{
 		std::vector<unsigned int> newContent(getWidth(), 0); // New height is equal to the current width
@@ -9,7 +9,7 @@ namespace TetrisAI {
 
 	public:
 		PolyominoState(std::vector<unsigned int> content);
-		PolyominoState(const PolyominoState & original) : content(original.content), width(original.width) {}
+		PolyominoState(const PolyominoState & original) : content(original.content), width(original.width), bottomProfile(original.bottomProfile), topProfile(original.topProfile) {}
 		
 		/// <summary>Translates a copy of the underlying raw content and returns it</summary>
 		std::vector<unsigned int> getTranslatedState(int translation) const;
@@ -19,13 +19,23 @@ namespace TetrisAI {
 
 		int getHeight() const;
 		int getWidth() const;
+		/// <summary>Returns the raw content of the piece (from its bottom row to its top row)</summary>
+		const std::vector<unsigned int>& getContent() const;
+
+		/// <summary>Returns, for each column of the piece (from right to left), the index of its lowest row containing a block</summary>
+		const std::vector<short>& getBottomProfile() const;
+		/// <summary>Returns, for each column of the piece (from right to left), the index of its highest row containing a block</summary>
+		const std::vector<short>& getTopProfile() const;
 		bool isEqual(PolyominoState const& b) const;
 
 	private:
 		std::vector<unsigned int> content;
 		short width;
+		std::vector<short> bottomProfile;
+		std::vector<short> topProfile;
 
 		void computeWidth();
+		void computeProfiles();
 		void transpose();
 		void reverseLines();
 	};
@@ -0,0 +1,36 @@
+#ifndef TETRISAI_ROW_H
+#define TETRISAI_ROW_H
+
+#include <cstdint>
+
+// Number of bits of a grid row, chosen at build time through the TETRISAI_ROW_BITS CMake option (16, 32 or 64)
+// Narrow rows make grids (and thus decision tree nodes) smaller while wide rows allow wider grids
+#ifndef TETRISAI_ROW_BITS
+#define TETRISAI_ROW_BITS 32
+#endif
+
+namespace TetrisAI {
+
+#if TETRISAI_ROW_BITS == 16
+	typedef std::uint16_t Row;
+#elif TETRISAI_ROW_BITS == 32
+	typedef std::uint32_t Row;
+#elif TETRISAI_ROW_BITS == 64
+	typedef std::uint64_t Row;
+#else
+#error "TETRISAI_ROW_BITS must be 16, 32 or 64"
+#endif
+
+	/// <summary>Number of blocks a row can hold (bit 0 being the rightmost one)</summary>
+	const int rowBits = TETRISAI_ROW_BITS;
+
+	/// <summary>Returns the value of a row whose width rightmost blocks are full (e.g. 1023 for a width of 10)</summary>
+	inline Row fullRow(int width)
+	{
+		// Shifting the complete row down avoids shifting a value by its own number of bits for the widest grids
+		return width ? static_cast<Row>(static_cast<Row>(~Row(0)) >> (rowBits - width)) : 0;
+	}
+
+}
+
+#endif
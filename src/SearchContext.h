@@ -0,0 +1,54 @@
+#ifndef TETRISAI_SEARCHCONTEXT_H
+#define TETRISAI_SEARCHCONTEXT_H
+
+#include <atomic>
+#include <vector>
+#include "Polyomino.h"
+#include "Heuristic.h"
+
+namespace TetrisAI {
+
+	class TranspositionTable;
+	class ThreadPool;
+	class MemoryBudget;
+	class ChanceSampling;
+	class DiscardedNodes;
+	class LazyExpansion;
+
+	/// <summary>Everything the nodes of a decision tree share while they are built and updated</summary>
+	struct SearchContext {
+		/// <summary>List of potential polyominos to populate the decision tree if needed</summary>
+		std::vector<Polyomino>& possiblePolyominos;
+		/// <summary>Heuristic that should be used to evaluate leaves and branches</summary>
+		Heuristic& heuristic;
+		/// <summary>Table where evaluated subtrees are shared between equal positions (nullptr if subtrees should not be shared)</summary>
+		TranspositionTable* transpositionTable;
+		/// <summary>Threads running the updates of the subtrees when multithreading is used (nullptr if the tree is always updated by the calling thread)</summary>
+		ThreadPool* threadPool;
+		/// <summary>Ceiling over which evaluated subtrees are collapsed (nullptr if the trees are never collapsed)</summary>
+		MemoryBudget* memoryBudget;
+		/// <summary>Subset of the possible polyominos expanded by the nodes whose next polyomino is unknown (nullptr if every possible polyomino is expanded)</summary>
+		ChanceSampling* chanceSampling;
+		/// <summary>Flag set to stop building the tree, the nodes not built yet being left as leaves (nullptr if the tree is always built entirely)</summary>
+		const std::atomic<bool>* cancellation;
+		/// <summary>Where the branches trimmed by the update are left to be destroyed by another thread (nullptr if they are destroyed at once)</summary>
+		DiscardedNodes* discardedNodes;
+		/// <summary>Selection of the moves expanded by the nodes whose next polyomino is known (nullptr if every move is expanded)</summary>
+		LazyExpansion* lazyExpansion;
+
+		SearchContext(std::vector<Polyomino>& possiblePolyominos, Heuristic& heuristic, TranspositionTable* transpositionTable = nullptr, ThreadPool* threadPool = nullptr,
+			MemoryBudget* memoryBudget = nullptr, ChanceSampling* chanceSampling = nullptr, const std::atomic<bool>* cancellation = nullptr,
+			DiscardedNodes* discardedNodes = nullptr, LazyExpansion* lazyExpansion = nullptr) :
+			possiblePolyominos(possiblePolyominos), heuristic(heuristic), transpositionTable(transpositionTable), threadPool(threadPool), memoryBudget(memoryBudget),
+			chanceSampling(chanceSampling), cancellation(cancellation), discardedNodes(discardedNodes), lazyExpansion(lazyExpansion) {}
+
+		/// <summary>Returns true once the building of the tree should stop</summary>
+		bool isCancelled() const
+		{
+			return cancellation != nullptr && cancellation->load(std::memory_order_relaxed);
+		}
+	};
+
+}
+
+#endif
@@ -0,0 +1,250 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace TetrisAI {
+
+	namespace {
+		/// <summary>Pool the calling thread is a worker of (nullptr if it is not a worker) and index of its queue</summary>
+		thread_local const ThreadPool* workerPool(nullptr);
+		thread_local unsigned workerQueue(0);
+	}
+
+	ThreadPool::TaskGroup::TaskGroup(ThreadPool& pool) : pool(pool), pendingTasks(0), exception(nullptr)
+	{
+	}
+
+	ThreadPool::TaskGroup::~TaskGroup()
+	{
+		try
+		{
+			wait();
+		}
+		catch (...)
+		{
+		}
+	}
+
+	void ThreadPool::TaskGroup::run(std::function<void()> task)
+	{
+		pendingTasks++;
+		pool.push(Task{ std::move(task), this, pool.currentQueue() });
+	}
+
+	void ThreadPool::TaskGroup::wait()
+	{
+		unsigned queue(pool.currentQueue());
+		while (pendingTasks > 0)
+		{
+			if (!pool.runPendingTask(queue))
+			{
+				// The remaining tasks of the group are being run by other threads: sleep until they are done or until a new task can be run meanwhile
+				Clock::time_point idleStart(Clock::now());
+				{
+					std::unique_lock<std::mutex> lock(pool.sleepMutex);
+					pool.waitingWakeUp.wait(lock, [this]() { return pendingTasks == 0 || pool.queuedTasks > 0; });
+				}
+				pool.addIdleTime(idleStart, Clock::now());
+			}
+		}
+
+		std::exception_ptr thrown(nullptr);
+		{
+			std::lock_guard<std::mutex> lock(exceptionMutex);
+			std::swap(thrown, exception);
+		}
+		if (thrown)
+		{
+			std::rethrow_exception(thrown);
+		}
+	}
+
+	ThreadPool::ThreadPool(unsigned workerCount) : queuedTasks(0), stopping(false), sleepStarts(workerCount), sleeping(workerCount, false),
+		statisticsStart(Clock::now().time_since_epoch().count()), idleNanoseconds(0), tasks(0), steals(0)
+	{
+		if (workerCount == 0)
+		{
+			throw std::invalid_argument("A thread pool needs at least one worker.");
+		}
+
+		for (unsigned i = 0; i <= workerCount; i++)
+		{
+			queues.push_back(std::make_unique<TaskQueue>());
+		}
+		workers.reserve(workerCount);
+		for (unsigned i = 0; i < workerCount; i++)
+		{
+			workers.push_back(std::thread(&ThreadPool::workerLoop, this, i));
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex);
+			stopping = true;
+		}
+		wakeUp.notify_all();
+		for (auto& worker : workers)
+		{
+			worker.join();
+		}
+	}
+
+	unsigned ThreadPool::getThreadCount() const
+	{
+		return workers.size() + 1;
+	}
+
+	void ThreadPool::resetStatistics()
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		statisticsStart = Clock::now().time_since_epoch().count();
+		idleNanoseconds = 0;
+		tasks = 0;
+		steals = 0;
+	}
+
+	ThreadPool::Statistics ThreadPool::getStatistics()
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		Clock::time_point now(Clock::now()), start(Clock::duration(statisticsStart.load()));
+
+		// Workers still sleeping have been idle since they fell asleep (or since the reset)
+		long long idle(idleNanoseconds);
+		for (unsigned i = 0; i < workers.size(); i++)
+		{
+			if (sleeping[i])
+			{
+				idle += std::chrono::duration_cast<std::chrono::nanoseconds>(now - std::max(sleepStarts[i], start)).count();
+			}
+		}
+
+		Statistics statistics;
+		statistics.seconds = std::chrono::duration<double>(now - start).count();
+		double threadSeconds(statistics.seconds * getThreadCount());
+		statistics.utilization = threadSeconds > 0 ? std::max(0.0, 1 - idle * 1e-9 / threadSeconds) : 0;
+		statistics.tasks = tasks;
+		statistics.steals = steals;
+		return statistics;
+	}
+
+	unsigned ThreadPool::currentQueue() const
+	{
+		return workerPool == this ? workerQueue : queues.size() - 1;
+	}
+
+	void ThreadPool::push(Task task)
+	{
+		{
+			TaskQueue& queue(*queues[task.queue]);
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.tasks.push_back(std::move(task));
+		}
+		queuedTasks++;
+
+		// Taking the lock makes sure that a thread checking for tasks before falling asleep either sees this one or gets notified
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex);
+		}
+		wakeUp.notify_one();
+		waitingWakeUp.notify_all();
+	}
+
+	bool ThreadPool::runPendingTask(unsigned queue)
+	{
+		Task task;
+		bool found(false);
+		{
+			// Most recent task of the own queue: the deepest part of the subtree the thread is working on
+			TaskQueue& own(*queues[queue]);
+			std::lock_guard<std::mutex> lock(own.mutex);
+			if (!own.tasks.empty())
+			{
+				task = std::move(own.tasks.back());
+				own.tasks.pop_back();
+				found = true;
+			}
+		}
+		for (unsigned i = 1; !found && i < queues.size(); i++)
+		{
+			// Oldest task of another queue: the largest part of the work left to that thread
+			TaskQueue& other(*queues[(queue + i) % queues.size()]);
+			std::lock_guard<std::mutex> lock(other.mutex);
+			if (!other.tasks.empty())
+			{
+				task = std::move(other.tasks.front());
+				other.tasks.pop_front();
+				found = true;
+			}
+		}
+		if (!found)
+		{
+			return false;
+		}
+
+		queuedTasks--;
+		tasks++;
+		if (task.queue != queue)
+		{
+			steals++;
+		}
+
+		try
+		{
+			task.function();
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(task.group->exceptionMutex);
+			if (!task.group->exception)
+			{
+				task.group->exception = std::current_exception();
+			}
+		}
+		// The group may be destroyed as soon as its last task is done: only the pool is used afterwards
+		if (--task.group->pendingTasks == 0)
+		{
+			{
+				std::lock_guard<std::mutex> lock(sleepMutex);
+			}
+			waitingWakeUp.notify_all();
+		}
+		return true;
+	}
+
+	void ThreadPool::workerLoop(unsigned queue)
+	{
+		workerPool = this;
+		workerQueue = queue;
+		while (true)
+		{
+			if (runPendingTask(queue))
+			{
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(sleepMutex);
+			sleepStarts[queue] = Clock::now();
+			sleeping[queue] = true;
+			wakeUp.wait(lock, [this]() { return stopping || queuedTasks > 0; });
+			sleeping[queue] = false;
+			Clock::time_point start(Clock::duration(statisticsStart.load()));
+			idleNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - std::max(sleepStarts[queue], start)).count();
+			if (stopping)
+			{
+				return;
+			}
+		}
+	}
+
+	void ThreadPool::addIdleTime(Clock::time_point idleStart, Clock::time_point now)
+	{
+		Clock::time_point start(Clock::duration(statisticsStart.load()));
+		if (now > start)
+		{
+			idleNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(now - std::max(idleStart, start)).count();
+		}
+	}
+
+}
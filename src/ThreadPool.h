@@ -0,0 +1,125 @@
+#ifndef TETRISAI_THREADPOOL_H
+#define TETRISAI_THREADPOOL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace TetrisAI {
+
+	/// <summary>
+	/// Persistent threads running tasks that may themselves run subtasks at any level of a recursion (e.g. of a decision tree update).
+	///
+	/// Each worker pushes the tasks it creates on its own queue and runs the most recent ones first, so that it goes deep into its
+	/// own subtree. Idle workers steal the oldest tasks of the other queues, which are the largest pieces of work left: large subtrees
+	/// are split dynamically between the threads instead of being assigned once to a single one.
+	/// A thread waiting for the tasks of a group runs pending tasks meanwhile, so that waiting inside a task does not block a worker.
+	/// </summary>
+	class ThreadPool {
+
+	public:
+		/// <summary>Measures collected since the last call to resetStatistics</summary>
+		struct Statistics {
+			double seconds;
+			/// <summary>Ratio of the time the threads (the workers and the thread waiting for the tasks) were not idle</summary>
+			double utilization;
+			unsigned long long tasks;
+			/// <summary>Number of tasks run by another thread than the one that created them</summary>
+			unsigned long long steals;
+		};
+
+		/// <summary>Tasks whose completion can be waited for as a whole</summary>
+		class TaskGroup {
+
+		public:
+			TaskGroup(ThreadPool& pool);
+			/// <summary>Waits for the remaining tasks (their exceptions are then ignored)</summary>
+			~TaskGroup();
+
+			/// <summary>Queues a task that will be run by any thread of the pool (or by the thread waiting for the group)</summary>
+			void run(std::function<void()> task);
+
+			/// <summary>Runs pending tasks until every task of the group is done</summary>
+			/// <exception>Rethrows the first exception thrown by a task of the group</exception>
+			void wait();
+
+		private:
+			friend class ThreadPool;
+
+			ThreadPool& pool;
+			std::atomic<int> pendingTasks;
+			std::mutex exceptionMutex;
+			std::exception_ptr exception;
+		};
+
+		/// <param name="workerCount">Number of threads created (the thread waiting for a group also runs tasks)</param>
+		/// <exception cred="std::invalid_argument">Thrown if workerCount is 0</exception>
+		ThreadPool(unsigned workerCount);
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+		~ThreadPool();
+
+		/// <summary>Returns the number of threads running tasks: the workers plus the thread waiting for them</summary>
+		unsigned getThreadCount() const;
+
+		void resetStatistics();
+		Statistics getStatistics();
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		struct Task {
+			std::function<void()> function;
+			TaskGroup* group;
+			/// <summary>Queue the task was pushed on</summary>
+			unsigned queue;
+		};
+
+		struct TaskQueue {
+			std::mutex mutex;
+			std::deque<Task> tasks;
+		};
+
+		/// <summary>One queue per worker, plus a last one shared by the threads that are not workers</summary>
+		std::vector<std::unique_ptr<TaskQueue>> queues;
+		std::vector<std::thread> workers;
+		std::atomic<int> queuedTasks;
+		bool stopping;
+
+		// Workers sleep while there is no task: they only change their state with sleepMutex held, as do the statistics
+		std::mutex sleepMutex;
+		std::condition_variable wakeUp;
+		/// <summary>Threads waiting for a group sleep on it while the pool has no task: notified when a task is queued or when a group has no pending task left</summary>
+		std::condition_variable waitingWakeUp;
+		/// <summary>Time at which each worker started to sleep (only meaningful while it is sleeping)</summary>
+		std::vector<Clock::time_point> sleepStarts;
+		std::vector<bool> sleeping;
+
+		/// <summary>Time at which the statistics were reset, as a count of Clock ticks (read by the threads accumulating idle time)</summary>
+		std::atomic<Clock::rep> statisticsStart;
+		/// <summary>Idle time of the threads since statisticsStart, in nanoseconds</summary>
+		std::atomic<long long> idleNanoseconds;
+		std::atomic<unsigned long long> tasks;
+		std::atomic<unsigned long long> steals;
+
+		/// <summary>Returns the queue of the calling thread</summary>
+		unsigned currentQueue() const;
+		void push(Task task);
+		/// <summary>Runs the most recent task of the given queue or, if it is empty, the oldest task of another queue</summary>
+		/// <returns>False if no task could be found</returns>
+		bool runPendingTask(unsigned queue);
+		void workerLoop(unsigned queue);
+		/// <summary>Adds the time elapsed since idleStart (or since the statistics were reset, if later) to the idle time</summary>
+		void addIdleTime(Clock::time_point idleStart, Clock::time_point now);
+	};
+
+}
+
+#endif
@@ -0,0 +1,88 @@
+#include "TranspositionTable.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace TetrisAI {
+
+	namespace {
+		const std::uint64_t usedEntryFlag(1ull << 40);
+
+		std::uint64_t packData(int depth, float childrenEvaluation)
+		{
+			std::uint32_t evaluationBits;
+			std::memcpy(&evaluationBits, &childrenEvaluation, sizeof(evaluationBits));
+			return usedEntryFlag | (std::uint64_t(depth & 0xFF) << 32) | evaluationBits;
+		}
+	}
+
+	TranspositionTable::TranspositionTable(unsigned sizeLog2) : indexMask((1ull << sizeLog2) - 1), probes(0), hits(0), stores(0)
+	{
+		if (sizeLog2 > maxSizeLog2)
+		{
+			throw std::invalid_argument("A transposition table can't hold more than 2^30 entries.");
+		}
+		entries.reset(new Entry[indexMask + 1]);
+		clear();
+	}
+
+	bool TranspositionTable::probe(std::uint64_t hash, int depth, float& childrenEvaluation)
+	{
+		probes.fetch_add(1, std::memory_order_relaxed);
+		Entry& entry(entries[hash & indexMask]);
+		std::uint64_t data(entry.data.load(std::memory_order_relaxed));
+		std::uint64_t check(entry.check.load(std::memory_order_relaxed));
+
+		if (!(data & usedEntryFlag) || (check ^ data) != hash || ((data >> 32) & 0xFF) != std::uint64_t(depth & 0xFF))
+		{
+			return false;
+		}
+
+		std::uint32_t evaluationBits(static_cast<std::uint32_t>(data));
+		std::memcpy(&childrenEvaluation, &evaluationBits, sizeof(evaluationBits));
+		hits.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	void TranspositionTable::store(std::uint64_t hash, int depth, float childrenEvaluation)
+	{
+		stores.fetch_add(1, std::memory_order_relaxed);
+		Entry& entry(entries[hash & indexMask]);
+		std::uint64_t data(packData(depth, childrenEvaluation));
+		entry.check.store(hash ^ data, std::memory_order_relaxed);
+		entry.data.store(data, std::memory_order_relaxed);
+	}
+
+	void TranspositionTable::clear()
+	{
+		for (std::uint64_t index = 0; index <= indexMask; index++)
+		{
+			entries[index].check.store(0, std::memory_order_relaxed);
+			entries[index].data.store(0, std::memory_order_relaxed);
+		}
+		probes = 0;
+		hits = 0;
+		stores = 0;
+	}
+
+	unsigned long long TranspositionTable::getProbes() const
+	{
+		return probes;
+	}
+
+	unsigned long long TranspositionTable::getHits() const
+	{
+		return hits;
+	}
+
+	unsigned long long TranspositionTable::getStores() const
+	{
+		return stores;
+	}
+
+	double TranspositionTable::getHitRate() const
+	{
+		unsigned long long probeCount(probes);
+		return probeCount ? (double)hits / probeCount : 0;
+	}
+
+}
@@ -0,0 +1,66 @@
+#ifndef TETRISAI_TRANSPOSITIONTABLE_H
+#define TETRISAI_TRANSPOSITIONTABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace TetrisAI {
+
+	/// <summary>
+	/// Fixed-size table storing the evaluation of the children of already evaluated decision tree nodes, keyed by the hash of their game state.
+	/// Different move orders often lead to the same grid and queue: the subtree of such a position only has to be built once.
+	///
+	/// The table can be shared by several threads without locking: each entry stores its data along with the xor of that data and
+	/// the key, so that an entry torn by concurrent writes does not match any key and is simply seen as a miss.
+	/// </summary>
+	class TranspositionTable {
+
+	public:
+		const static unsigned maxSizeLog2 = 30;
+
+		/// <param name="sizeLog2">The table holds 2^sizeLog2 entries (16 bytes each)</param>
+		/// <exception cred="std::invalid_argument">Thrown if the requested size exceeds 2^maxSizeLog2 entries</exception>
+		TranspositionTable(unsigned sizeLog2);
+
+		/// <summary>Retrieves the evaluation stored for a position</summary>
+		/// <param name="hash">Hash of the game state</param>
+		/// <param name="depth">Number of moves the stored evaluation must consider from that game state</param>
+		/// <param name="childrenEvaluation">Receives the evaluation of the children of the node if it was found</param>
+		/// <returns>True if the position was found with the same depth</returns>
+		bool probe(std::uint64_t hash, int depth, float& childrenEvaluation);
+
+		/// <summary>Stores the evaluation of the children of a node (replacing any entry sharing its slot)</summary>
+		/// <param name="hash">Hash of the game state</param>
+		/// <param name="depth">Number of moves considered by the evaluation from that game state</param>
+		/// <param name="childrenEvaluation">Evaluation of the children of the node</param>
+		void store(std::uint64_t hash, int depth, float childrenEvaluation);
+
+		/// <summary>Removes every entry and resets the counters</summary>
+		void clear();
+
+		unsigned long long getProbes() const;
+		unsigned long long getHits() const;
+		unsigned long long getStores() const;
+		/// <summary>Returns the ratio of probes that found their position (0 if nothing was probed)</summary>
+		double getHitRate() const;
+
+	private:
+		struct Entry {
+			/// <summary>Xor of the key and the data</summary>
+			std::atomic<std::uint64_t> check;
+			/// <summary>Evaluation (low 32 bits), depth (next 8 bits) and a flag telling that the entry is used</summary>
+			std::atomic<std::uint64_t> data;
+		};
+
+		std::unique_ptr<Entry[]> entries;
+		std::uint64_t indexMask;
+
+		std::atomic<unsigned long long> probes;
+		std::atomic<unsigned long long> hits;
+		std::atomic<unsigned long long> stores;
+	};
+
+}
+
+#endif
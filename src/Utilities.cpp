@@ -1,17 +1,12 @@
 #include "Utilities.h"
 #include <stdexcept>
+#include "BitKernels.h"
 
 namespace TetrisAI {
 
-	int activeBitsCount(unsigned int value)
+	int activeBitsCount(std::uint64_t value)
 	{
-		// Brian Kernighan's way as presentend here: http://graphics.stanford.edu/~seander/bithacks.html#CountBitsSetKernighan
-		unsigned int count;
-		for (count = 0; value; count++)
-		{
-			value &= value - 1; // clear the least significant bit set
-		}
-		return count;
+		return BitKernels::get().activeBitsCount(value);
 	}
 
 	std::vector<int> splitRange(int start, unsigned length, unsigned parts)
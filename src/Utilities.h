@@ -2,11 +2,20 @@
 #define TETRISAI_UTILITIES_H
 
 #include <vector>
+#include <cstdint>
 
 namespace TetrisAI {
 
 	/// <summary>Returns the count of bits set to 1 in the given value</summary>
-	int activeBitsCount(unsigned int value);
+	int activeBitsCount(std::uint64_t value);
+
+	/// <summary>Scrambles the bits of the given value so that close inputs give unrelated outputs (finalizer of the SplitMix64 generator)</summary>
+	inline std::uint64_t hashMix(std::uint64_t value)
+	{
+		value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+		value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+		return value ^ (value >> 31);
+	}
 
 	/// <summary>Divide the given range into a number of smaller ranges and outputs a vector storing the starting point of those subranges</summary>
 	/// <param name="start">Start of the range</param>
@@ -1,14 +1,23 @@
 #include <boost/program_options.hpp>
 #include <iostream>
+#include <string>
 #include "GameSequence.h"
 #include "GridView.h"
 #include "Grid.h"
 #include "GameStatusView.h"
 #include "DellacherieHeuristic.h"
 #include "HeuristicStrategy.h"
+#include "FlatTreeStrategy.h"
+#include "ExpectimaxStrategy.h"
+#include "BeamSearchStrategy.h"
+#include "MonteCarloStrategy.h"
+#include "TranspositionTable.h"
+#include "ChanceSampling.h"
+#include "LazyExpansion.h"
 #include <SFML/Graphics.hpp>
 #include <thread>
 #include <chrono>
+#include <limits>
 
 using namespace TetrisAI;
 
@@ -56,22 +65,41 @@ void gameView(GameSequence& gameSequence, unsigned int refreshRate)
 int main(int argc, char* argv[])
 {
 	int height(20), width(10), polyominoSquares(4);
-	unsigned stepsAhead(0), heuristicDepth(1);
-	bool noWindow(false), useMultithreading(false);
+	unsigned stepsAhead(0), heuristicDepth(1), transpositionTableSizeLog2(0), moveTime(0), beamWidth(0), rollouts(0), memoryBudget(0), chanceSamples(0), lazyWidth(0);
+	float lazyMargin(0);
+	bool noWindow(false), useMultithreading(false), useColumnLayout(false), useFlatTree(false), useMonteCarlo(false), usePruning(false), useStratifiedSampling(false), usePondering(false);
+	std::string polyominoCache(".");
 
 	// PARSING PROGRAM OPTIONS
 	namespace po = boost::program_options;
-	// Declare the supported options.
+	// Declare the supported options (the widest grid depends on the row type the library is built with)
+	std::string widthDescription("set width of the grid [4-" + std::to_string(Grid::maxWidth) + "]");
+	std::string polyominoDescription("set the number of squares composing polyominos [1-" + std::to_string(Polyomino::maxSquares) + "]");
 	po::options_description desc("Allowed options");
 	desc.add_options()
 		("help", "produce help message")
 		("height,h", po::value<int>()->default_value(height), "set height of the grid [4-32]")
-		("width,w", po::value<int>()->default_value(width), "set width of the grid [4-32]")
-		("polyomino,p", po::value<int>()->default_value(polyominoSquares), "set the number of squares composing polyominos [1-5]")
+		("width,w", po::value<int>()->default_value(width), widthDescription.c_str())
+		("polyomino,p", po::value<int>()->default_value(polyominoSquares), polyominoDescription.c_str())
+		("polyominoCache", po::value<std::string>(&polyominoCache)->default_value(polyominoCache), "set the directory where polyominos of more than 5 squares are cached once enumerated (empty to disable the cache)")
 		("stepsAhead,s", po::value<unsigned int>()->default_value(stepsAhead), "set the number of polyominos known in advance (excepting the one currently being played) [0-5]")
-		("heuristicDepth,d", po::value<unsigned int>()->default_value(heuristicDepth), "set the number of moves the decision tree should consider in advance [1-4]")
+		("heuristicDepth,d", po::value<unsigned int>()->default_value(heuristicDepth), "set the number of moves the decision tree should consider in advance [1-4, 1-32 with beamWidth, monteCarlo or pruning and moveTime]")
 		("noWindow", po::bool_switch(&noWindow), "disable the window that displays the grid")
 		("multithreading", po::bool_switch(&useMultithreading), "enable multithreading for AI computations")
+		("columnLayout", po::bool_switch(&useColumnLayout), "maintain a column-major copy of the grid for the per-column evaluations (not faster than the row-major grid yet)")
+		("transpositionTable", po::value<unsigned int>(&transpositionTableSizeLog2)->default_value(transpositionTableSizeLog2), "share the evaluation of equal positions in a table of 2^n entries (0 disables it) [0-30]")
+		("memoryBudget", po::value<unsigned int>(&memoryBudget)->default_value(memoryBudget), "collapse the least valuable subtrees of the decision tree once its nodes hold the given megabytes (0 disables it)")
+		("chanceSamples", po::value<unsigned int>(&chanceSamples)->default_value(chanceSamples), "expand only the given number of polyominos when the next polyomino is unknown, weighting them by the number of polyominos they stand for (0 expands all of them)")
+		("stratified", po::bool_switch(&useStratifiedSampling), "draw the chanceSamples polyominos one in each group of consecutive polyominos instead of uniformly")
+		("lazyWidth", po::value<unsigned int>(&lazyWidth)->default_value(lazyWidth), "expand only the given number of moves of each node, the best evaluated on their own (0 expands every move)")
+		("lazyMargin", po::value<float>(&lazyMargin)->default_value(lazyMargin), "with lazyWidth, do not expand the moves evaluated more than the given margin below the best one (0 disables it)")
+		("ponder", po::bool_switch(&usePondering), "keep building the decision tree on a background thread between the moves")
+		("flatTree", po::bool_switch(&useFlatTree), "store the decision tree level by level in contiguous arrays (without multithreading nor transposition table)")
+		("pruning", po::bool_switch(&usePruning), "search the decision tree without storing it, skipping the subtrees that cannot change the decision (without multithreading nor transposition table)")
+		("beamWidth", po::value<unsigned int>(&beamWidth)->default_value(beamWidth), "keep only the given number of game states after each move, allowing heuristicDepth up to 32 (0 disables it)")
+		("monteCarlo", po::bool_switch(&useMonteCarlo), "grow a Monte Carlo tree whose rollouts play heuristicDepth moves each, limited by rollouts, moveTime or both")
+		("rollouts", po::value<unsigned int>(&rollouts)->default_value(rollouts), "with monteCarlo, which it implies, do the given number of rollouts per move (0 only stops them after moveTime, at least one rollout per possible placement is done)")
+		("moveTime", po::value<unsigned int>(&moveTime)->default_value(moveTime), "with monteCarlo or pruning only, stop the rollouts, or deepen the search of --pruning one move at a time, once the given milliseconds per move are spent (0 disables it)")
 		;
 
 	po::variables_map vm;
@@ -92,9 +120,9 @@ int main(int argc, char* argv[])
 		if (vm.count("heuristicDepth")) { heuristicDepth = vm["heuristicDepth"].as<unsigned int>(); }
 
 		// Checking values ranges
-		if (height < Grid::minSize || height > Grid::maxSize || width < Grid::minSize || width > Grid::maxSize)
+		if (height < Grid::minSize || height > Grid::maxHeight || width < Grid::minSize || width > Grid::maxWidth)
 		{
-			std::cout << "Grid size out of range [" << Grid::minSize << "-" << Grid::maxSize << "]" << std::endl;
+			std::cout << "Grid size out of range: width [" << Grid::minSize << "-" << Grid::maxWidth << "], height [" << Grid::minSize << "-" << Grid::maxHeight << "]" << std::endl;
 			return 1;
 		}
 		if (polyominoSquares < 1 || polyominoSquares > Polyomino::maxSquares)
@@ -107,9 +135,55 @@ int main(int argc, char* argv[])
 			std::cout << "Steps ahead parameter out of range [0-" << GameSequence::maxStepsAhead << "]" << std::endl;
 			return 1;
 		}
-		if (heuristicDepth < 1 || heuristicDepth > HeuristicStrategy::maxDepth)
+		// Each strategy has its own options: combinations that would silently drop some of them are rejected
+		std::vector<std::string> strategies, treeOptions;
+		if (beamWidth > 0) { strategies.push_back("beamWidth"); }
+		if (rollouts > 0) { strategies.push_back("rollouts"); }
+		else if (useMonteCarlo) { strategies.push_back("monteCarlo"); }
+		useMonteCarlo = useMonteCarlo || rollouts > 0;
+		if (useFlatTree) { strategies.push_back("flatTree"); }
+		if (usePruning) { strategies.push_back("pruning"); }
+		if (transpositionTableSizeLog2 > 0) { treeOptions.push_back("transpositionTable"); }
+		if (memoryBudget > 0) { treeOptions.push_back("memoryBudget"); }
+		if (chanceSamples > 0) { treeOptions.push_back("chanceSamples"); }
+		if (lazyWidth > 0) { treeOptions.push_back("lazyWidth"); }
+		if (usePondering) { treeOptions.push_back("ponder"); }
+		if (strategies.size() > 1)
 		{
-			std::cout << "Heuristic depth parameter out of range [1-" << HeuristicStrategy::maxDepth << "]" << std::endl;
+			throw po::error("--" + strategies[0] + " and --" + strategies[1] + " select different strategies");
+		}
+		if (!strategies.empty() && !treeOptions.empty())
+		{
+			throw po::error("--" + treeOptions[0] + " only applies to the decision tree, not to --" + strategies[0]);
+		}
+		if (useMultithreading && !strategies.empty() && !useMonteCarlo)
+		{
+			throw po::error("--multithreading does not apply to --" + strategies[0]);
+		}
+		if (moveTime > 0 && !usePruning && !useMonteCarlo)
+		{
+			throw po::error("--moveTime only applies to --pruning or --monteCarlo");
+		}
+		if (useMonteCarlo && rollouts == 0 && moveTime == 0)
+		{
+			throw po::error("--monteCarlo requires --rollouts, --moveTime or both");
+		}
+		if (useStratifiedSampling && chanceSamples == 0)
+		{
+			throw po::error("--stratified requires --chanceSamples");
+		}
+		if (lazyMargin > 0 && lazyWidth == 0)
+		{
+			throw po::error("--lazyMargin requires --lazyWidth");
+		}
+
+		// Beam searches only keep a few game states per move and rollouts a single one: they can consider many more moves than decision trees,
+		// as can an expectimax search, which stores nothing, when a time budget deepens it no further than it can afford
+		int maxDepth(beamWidth > 0 ? BeamSearchStrategy::maxDepth : useMonteCarlo ? MonteCarloStrategy::maxDepth :
+			usePruning && moveTime > 0 ? ExpectimaxStrategy::maxDepth : HeuristicStrategy::maxDepth);
+		if (heuristicDepth < 1 || heuristicDepth > maxDepth)
+		{
+			std::cout << "Heuristic depth parameter out of range [1-" << maxDepth << "]" << std::endl;
 			return 1;
 		}
 
@@ -129,9 +203,37 @@ int main(int argc, char* argv[])
 	}
 
 	// MAIN PROGRAM
+	Polyomino::setCacheDirectory(polyominoCache);
 	DellacherieHeuristic chosenHeuristic;
-	std::shared_ptr<AIStrategy> strategy(std::make_shared<HeuristicStrategy>(chosenHeuristic, heuristicDepth, useMultithreading));
-	GameSequence gameSequence(width, height, polyominoSquares, strategy, stepsAhead);
+	std::unique_ptr<TranspositionTable> transpositionTable(transpositionTableSizeLog2 > 0 ? std::make_unique<TranspositionTable>(transpositionTableSizeLog2) : nullptr);
+	std::unique_ptr<ChanceSampling> chanceSampling(chanceSamples > 0 ?
+		std::make_unique<ChanceSampling>(chanceSamples, useStratifiedSampling ? ChanceSampling::Method::Stratified : ChanceSampling::Method::Random) : nullptr);
+	std::unique_ptr<LazyExpansion> lazyExpansion(lazyWidth > 0 ?
+		std::make_unique<LazyExpansion>(lazyWidth, lazyMargin > 0 ? lazyMargin : std::numeric_limits<float>::infinity()) : nullptr);
+	std::shared_ptr<AIStrategy> strategy;
+	if (beamWidth > 0)
+	{
+		strategy = std::make_shared<BeamSearchStrategy>(chosenHeuristic, heuristicDepth, beamWidth);
+	}
+	else if (useMonteCarlo)
+	{
+		unsigned cores(std::thread::hardware_concurrency());
+		strategy = std::make_shared<MonteCarloStrategy>(chosenHeuristic, rollouts, heuristicDepth, useMultithreading && cores > 1 ? cores : 1, std::chrono::milliseconds(moveTime));
+	}
+	else if (useFlatTree)
+	{
+		strategy = std::make_shared<FlatTreeStrategy>(chosenHeuristic, heuristicDepth);
+	}
+	else if (usePruning)
+	{
+		strategy = std::make_shared<ExpectimaxStrategy>(chosenHeuristic, heuristicDepth, true, std::chrono::milliseconds(moveTime));
+	}
+	else
+	{
+		strategy = std::make_shared<HeuristicStrategy>(chosenHeuristic, heuristicDepth, useMultithreading, transpositionTable.get(), std::size_t(memoryBudget) * 1024 * 1024, chanceSampling.get(),
+			usePondering, lazyExpansion.get());
+	}
+	GameSequence gameSequence(width, height, polyominoSquares, strategy, stepsAhead, useColumnLayout ? Grid::Layout::RowAndColumnMajor : Grid::Layout::RowMajor);
 
 	std::vector<std::thread> threads;
 	threads.push_back(std::thread(&GameSequence::playGame, &gameSequence));
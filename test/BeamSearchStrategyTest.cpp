@@ -0,0 +1,57 @@
+#include <boost/test/unit_test.hpp>
+#include <random>
+#include <stdexcept>
+#include "BeamSearchStrategy.h"
+#include "DellacherieHeuristic.h"
+#include "StrategyTestHelpers.h"
+
+using namespace TetrisAI;
+
+namespace {
+
+	/// <summary>Plays a game with a beam keeping every state and checks every decision against a tree of nodes built from scratch</summary>
+	void checkAgainstNodeTree(unsigned squares, unsigned stepsAhead, unsigned depth, unsigned moves)
+	{
+		DellacherieHeuristic heuristic;
+		TetrisAI::checkAgainstNodeTree<BeamSearchStrategy>(heuristic, [&heuristic](unsigned depth) { return std::make_unique<BeamSearchStrategy>(heuristic, depth, 100000); },
+			8, 12, squares, stepsAhead, depth, moves, 3);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(beam_search_strategy_test) {
+	DellacherieHeuristic heuristic;
+	BOOST_CHECK_THROW(BeamSearchStrategy(heuristic, 0, 8), std::invalid_argument);
+	BOOST_CHECK_THROW(BeamSearchStrategy(heuristic, BeamSearchStrategy::maxDepth + 1, 8), std::invalid_argument);
+	BOOST_CHECK_THROW(BeamSearchStrategy(heuristic, 4, 0), std::invalid_argument);
+
+	// Without unknown polyominos and with a beam wide enough to keep every state, the search is the one of a decision tree
+	checkAgainstNodeTree(3, 0, 1, 30);
+	checkAgainstNodeTree(4, 0, 1, 20);
+	checkAgainstNodeTree(3, 1, 2, 30);
+	checkAgainstNodeTree(4, 2, 3, 10);
+}
+
+BOOST_AUTO_TEST_CASE(beam_search_strategy_depth_test) {
+	// Deep searches evaluate a number of states growing linearly with the depth and are repeatable for a given seed
+	std::vector<Polyomino> polyominos(Polyomino::getPolyominosList(4));
+	DellacherieHeuristic heuristic;
+	unsigned depth(10), width(8), moves(20);
+	BeamSearchStrategy strategy(heuristic, depth, width, 2, 7), sameSeed(heuristic, depth, width, 2, 7);
+
+	std::mt19937 generator(5);
+	GameState gameState(10, 20);
+	for (unsigned move = 0; move < moves; move++)
+	{
+		gameState.addPolyominoToQueue(&polyominos[generator() % polyominos.size()]);
+		Transformation decision(strategy.decideMove(gameState, polyominos));
+		Transformation sameSeedDecision(sameSeed.decideMove(gameState, polyominos));
+		BOOST_REQUIRE(decision.translation != -1);
+		BOOST_CHECK_EQUAL(decision.translation, sameSeedDecision.translation);
+		BOOST_CHECK_EQUAL(decision.rotation, sameSeedDecision.rotation);
+		gameState.play(decision);
+	}
+
+	// At most 34 placements of a tetromino in a grid of width 10 for every state kept by each ply and each sample
+	BOOST_CHECK(strategy.getEvaluatedNodes() > 0);
+	BOOST_CHECK(strategy.getEvaluatedNodes() <= moves * 2 * (34 + (depth - 1) * width * 34));
+}
@@ -0,0 +1,161 @@
+#include <boost/test/unit_test.hpp>
+#include "BitKernels.h"
+#include <random>
+#include <vector>
+
+using namespace TetrisAI;
+
+namespace {
+	// Straightforward block by block implementations used as references
+	bool isFull(const std::vector<Row>& rows, int row, int col) 
+	{ 
+		return (rows[row] >> col) & 1; 
+	}
+
+	int referenceRowTransitions(const std::vector<Row>& rows, int width)
+	{
+		int output(0);
+		for (int row = 0; row < (int)rows.size(); row++)
+		{
+			for (int col = -1; col < width; col++)
+			{
+				bool right(col < 0 || isFull(rows, row, col)), left(col + 1 >= width || isFull(rows, row, col + 1));
+				output += right != left;
+			}
+		}
+		return output;
+	}
+
+	int referenceColumnTransitions(const std::vector<Row>& rows, int width)
+	{
+		int output(0);
+		for (int col = 0; col < width; col++)
+		{
+			for (int row = -1; row < (int)rows.size(); row++)
+			{
+				bool below(row < 0 || isFull(rows, row, col)), above(row + 1 < (int)rows.size() && isFull(rows, row + 1, col));
+				output += below != above;
+			}
+		}
+		return output;
+	}
+
+	int referenceWells(const std::vector<Row>& rows, int width)
+	{
+		int output(0);
+		for (int row = 0; row < (int)rows.size(); row++)
+		{
+			for (int col = 0; col < width; col++)
+			{
+				bool left(col + 1 >= width || isFull(rows, row, col + 1)), right(col == 0 || isFull(rows, row, col - 1));
+				if (!isFull(rows, row, col) && left && right)
+				{
+					for (int below = row; below >= 0 && !isFull(rows, below, col); below--)
+					{
+						output++;
+					}
+				}
+			}
+		}
+		return output;
+	}
+
+	int referenceCellars(const std::vector<Row>& rows, int width)
+	{
+		int output(0);
+		for (int col = 0; col < width; col++)
+		{
+			bool roof(false);
+			for (int row = rows.size() - 1; row >= 0; row--)
+			{
+				output += roof && !isFull(rows, row, col);
+				roof = roof || isFull(rows, row, col);
+			}
+		}
+		return output;
+	}
+
+	std::vector<unsigned int> transpose(const std::vector<Row>& rows, int width)
+	{
+		std::vector<unsigned int> columns(width);
+		for (int row = 0; row < (int)rows.size(); row++)
+		{
+			for (int col = 0; col < width; col++)
+			{
+				columns[col] |= (unsigned int)isFull(rows, row, col) << row;
+			}
+		}
+		return columns;
+	}
+
+	Row randomRow(std::mt19937& generator)
+	{
+		return static_cast<Row>(((std::uint64_t)generator() << 32) | generator());
+	}
+
+	void checkKernels(const BitKernels& kernels)
+	{
+		std::mt19937 generator(1234);
+		for (int width = 4; width <= rowBits; width++)
+		{
+			Row fullLine(fullRow(width));
+			for (int trial = 0; trial < 20; trial++)
+			{
+				std::vector<Row> rows(1 + generator() % 32);
+				int blocks(0);
+				for (auto& row : rows)
+				{
+					row = randomRow(generator) & randomRow(generator) & fullLine; // Sparse rows to get wells and runs of empty blocks
+					for (int col = 0; col < width; col++)
+					{
+						blocks += (row >> col) & 1;
+					}
+				}
+
+				BOOST_CHECK_EQUAL(kernels.blocksCount(rows.data(), rows.size()), blocks);
+				BOOST_CHECK_EQUAL(kernels.rowTransitions(rows.data(), rows.size(), width), referenceRowTransitions(rows, width));
+				BOOST_CHECK_EQUAL(kernels.columnTransitions(rows.data(), rows.size(), width), referenceColumnTransitions(rows, width));
+				BOOST_CHECK_EQUAL(kernels.wells(rows.data(), rows.size(), width), referenceWells(rows, width));
+
+				std::vector<unsigned int> columns(transpose(rows, width));
+				BOOST_CHECK_EQUAL(kernels.columnCellars(columns.data(), width), referenceCellars(rows, width));
+				BOOST_CHECK_EQUAL(kernels.columnWells(columns.data(), width, rows.size()), referenceWells(rows, width));
+
+				// Compacting the columns must give the columns of the grid where the removed rows were erased
+				unsigned int keptRows(generator() | generator());
+				std::vector<Row> keptRowsContent;
+				for (int row = 0; row < (int)rows.size(); row++)
+				{
+					if ((keptRows >> row) & 1)
+					{
+						keptRowsContent.push_back(rows[row]);
+					}
+				}
+				std::vector<unsigned int> expectedColumns(transpose(keptRowsContent, width));
+				kernels.compactColumns(columns.data(), width, keptRows);
+				BOOST_CHECK_EQUAL_COLLECTIONS(columns.begin(), columns.end(), expectedColumns.begin(), expectedColumns.end());
+			}
+		}
+
+		BOOST_CHECK_EQUAL(kernels.activeBitsCount(0), 0);
+		BOOST_CHECK_EQUAL(kernels.activeBitsCount(4294967295), 32);
+		BOOST_CHECK_EQUAL(kernels.activeBitsCount(17), 2);
+		BOOST_CHECK_EQUAL(kernels.activeBitsCount(18446744073709551615ull), 64);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(bit_length_test) {
+	BOOST_CHECK_EQUAL(bitLength(0), 0);
+	BOOST_CHECK_EQUAL(bitLength(1), 1);
+	BOOST_CHECK_EQUAL(bitLength(12), 4);
+	BOOST_CHECK_EQUAL(bitLength(4294967295), 32);
+}
+
+BOOST_AUTO_TEST_CASE(bit_kernels_portable_test) {
+	checkKernels(BitKernels::portable());
+}
+
+BOOST_AUTO_TEST_CASE(bit_kernels_selected_test) {
+	BOOST_TEST_MESSAGE("Selected kernels: " << BitKernels::get().name);
+	checkKernels(BitKernels::get());
+}
@@ -1,9 +1,15 @@
 #include <boost/test/unit_test.hpp>
 #include <memory>
+#include <stdexcept>
 #include "DecisionTreeNode.h"
 #include "GameStateNode.h"
 #include "PolyominoNode.h"
 #include "Heuristic.h"
+#include "TranspositionTable.h"
+#include "ThreadPool.h"
+#include "MemoryBudget.h"
+#include "ChanceSampling.h"
+#include "LazyExpansion.h"
 
 using namespace TetrisAI;
 
@@ -12,7 +18,7 @@ class MockHeuristic : public Heuristic {
 		virtual float evaluate(const GameState& gs)
 		{
 			float output(0);
-			const std::vector<unsigned> grid(gs.getGrid().getContent());
+			const std::vector<Row> grid(gs.getGrid().getContent());
 			for (auto& row : grid)
 			{
 				output -= row;
@@ -145,4 +151,265 @@ BOOST_AUTO_TEST_CASE(decision_tree_node_update_tree_tree) {
 	BOOST_CHECK_EQUAL(mixedCaseStatus[3]["GameStateNode"], 216); // (6+12)*Layer[N-2] > 6 possibilities for I, 12 for L in grid of width 4
 	BOOST_CHECK_EQUAL(mixedCaseStatus.size(), 4);
 	BOOST_CHECK(mixedCase->getNodeEvaluation() != -2.5); // Should have been updated
-}
\ No newline at end of file
+}
+BOOST_AUTO_TEST_CASE(decision_tree_node_transposition_test) {
+	// Sharing the evaluation of equal positions must not change the evaluation of the tree while building fewer nodes
+	GameState initialGameState(6, 6);
+	std::vector<Polyomino> triominos(Polyomino::getPolyominosList(3));
+	MockHeuristic heuristic;
+	TranspositionTable table(16);
+	initialGameState.addPolyominoToQueue(&(triominos[0]));
+
+	int depth(3);
+	std::unique_ptr<DecisionTreeNode> fullTree(std::make_unique<GameStateNode>(initialGameState, depth, SearchContext(triominos, heuristic)));
+	std::unique_ptr<DecisionTreeNode> sharedTree(std::make_unique<GameStateNode>(initialGameState, depth, SearchContext(triominos, heuristic, &table)));
+	BOOST_CHECK_EQUAL(fullTree->getNodeEvaluation(), sharedTree->getNodeEvaluation());
+	BOOST_CHECK(table.getHits() > 0);
+	BOOST_CHECK(sharedTree->getNodeStatus()[5]["GameStateNode"] < fullTree->getNodeStatus()[5]["GameStateNode"]);
+
+	// Nodes whose evaluation came from the table are built when the tree is updated from them
+	for (int move = 0; move < 3; move++)
+	{
+		fullTree = fullTree->extractBestChild();
+		sharedTree = sharedTree->extractBestChild();
+		BOOST_CHECK_EQUAL(fullTree->getPolyominoMove().translation, sharedTree->getPolyominoMove().translation);
+		BOOST_CHECK_EQUAL(fullTree->getPolyominoMove().rotation, sharedTree->getPolyominoMove().rotation);
+
+		fullTree->updateTree(&(triominos[move % 2]), depth, SearchContext(triominos, heuristic), false);
+		sharedTree->updateTree(&(triominos[move % 2]), depth, SearchContext(triominos, heuristic, &table), false);
+		BOOST_CHECK_EQUAL(fullTree->getNodeEvaluation(), sharedTree->getNodeEvaluation());
+	}
+}
+
+BOOST_AUTO_TEST_CASE(decision_tree_node_thread_pool_test) {
+	// Updating the subtrees as tasks of a thread pool must give the same tree as a serial update
+	GameState initialGameState(6, 8);
+	std::vector<Polyomino> triominos(Polyomino::getPolyominosList(3));
+	MockHeuristic heuristic;
+	ThreadPool pool(3);
+	initialGameState.addPolyominoToQueue(&(triominos[0]));
+
+	int depth(3);
+	std::unique_ptr<DecisionTreeNode> serialTree(std::make_unique<GameStateNode>(initialGameState, depth, SearchContext(triominos, heuristic)));
+	std::unique_ptr<DecisionTreeNode> pooledTree(std::make_unique<GameStateNode>(initialGameState, depth, SearchContext(triominos, heuristic)));
+	for (int move = 0; move < 4; move++)
+	{
+		serialTree = serialTree->extractBestChild();
+		pooledTree = pooledTree->extractBestChild();
+		BOOST_CHECK_EQUAL(serialTree->getPolyominoMove().translation, pooledTree->getPolyominoMove().translation);
+		BOOST_CHECK_EQUAL(serialTree->getPolyominoMove().rotation, pooledTree->getPolyominoMove().rotation);
+
+		pool.resetStatistics();
+		serialTree->updateTree(&(triominos[move % 2]), depth, SearchContext(triominos, heuristic), false);
+		pooledTree->updateTree(&(triominos[move % 2]), depth, SearchContext(triominos, heuristic, nullptr, &pool), true);
+		BOOST_CHECK_EQUAL(serialTree->getNodeEvaluation(), pooledTree->getNodeEvaluation());
+		BOOST_CHECK(serialTree->getNodeStatus() == pooledTree->getNodeStatus());
+		BOOST_CHECK(pool.getStatistics().tasks > 0);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(decision_tree_node_parallel_build_test) {
+	// Building a tree as tasks of a thread pool, unknown polyominos included, must give the same tree as a serial build
+	// (a context holding a pool only builds the tree with it if multithreading is asked for, as updateTree does)
+	GameState initialGameState(6, 8);
+	std::vector<Polyomino> triominos(Polyomino::getPolyominosList(3));
+	MockHeuristic heuristic;
+	ThreadPool pool(3);
+
+	for (int depth = 1; depth <= 3; depth++)
+	{
+		pool.resetStatistics();
+		GameStateNode serialTree(initialGameState, depth, SearchContext(triominos, heuristic, nullptr, &pool), false);
+		BOOST_CHECK_EQUAL(pool.getStatistics().tasks, 0);
+		GameStateNode pooledTree(initialGameState, depth, SearchContext(triominos, heuristic, nullptr, &pool), true);
+		BOOST_CHECK_EQUAL(serialTree.getNodeEvaluation(), pooledTree.getNodeEvaluation());
+		BOOST_CHECK(serialTree.getNodeStatus() == pooledTree.getNodeStatus());
+		BOOST_CHECK_EQUAL(pool.getStatistics().tasks > 0, depth > 1);
+
+		std::unique_ptr<DecisionTreeNode> serialBest(serialTree.extractBestChild());
+		std::unique_ptr<DecisionTreeNode> pooledBest(pooledTree.extractBestChild());
+		BOOST_CHECK_EQUAL(serialBest->getNodeEvaluation(), pooledBest->getNodeEvaluation());
+		BOOST_CHECK(serialBest->getNodeStatus() == pooledBest->getNodeStatus());
+	}
+}
+
+BOOST_AUTO_TEST_CASE(decision_tree_node_memory_budget_test) {
+	// Collapsing evaluated subtrees must not change the evaluations nor the decisions, the subtrees being rebuilt when the tree is updated from them
+	GameState initialGameState(6, 8);
+	std::vector<Polyomino> triominos(Polyomino::getPolyominosList(3));
+	MockHeuristic heuristic;
+	ThreadPool pool(3);
+	BOOST_CHECK_THROW(MemoryBudget(0), std::invalid_argument);
+	MemoryBudget budget(1);
+	initialGameState.addPolyominoToQueue(&(triominos[0]));
+
+	int depth(3);
+	std::unique_ptr<DecisionTreeNode> fullTree(std::make_unique<GameStateNode>(initialGameState, depth, SearchContext(triominos, heuristic)));
+	std::unique_ptr<DecisionTreeNode> budgetTree(std::make_unique<GameStateNode>(initialGameState, depth, SearchContext(triominos, heuristic, nullptr, nullptr, &budget)));
+	BOOST_CHECK_EQUAL(fullTree->getNodeEvaluation(), budgetTree->getNodeEvaluation());
+	BOOST_CHECK(budget.getCollapses() > 0);
+	BOOST_CHECK(budgetTree->getNodeStatus().size() < fullTree->getNodeStatus().size());
+
+	for (int move = 0; move < 4; move++)
+	{
+		fullTree = fullTree->extractBestChild();
+		budgetTree = budgetTree->extractBestChild();
+		BOOST_CHECK_EQUAL(fullTree->getPolyominoMove().translation, budgetTree->getPolyominoMove().translation);
+		BOOST_CHECK_EQUAL(fullTree->getPolyominoMove().rotation, budgetTree->getPolyominoMove().rotation);
+
+		budget.resetStatistics();
+		fullTree->updateTree(&(triominos[move % 2]), depth, SearchContext(triominos, heuristic), false);
+		budgetTree->updateTree(&(triominos[move % 2]), depth, SearchContext(triominos, heuristic, nullptr, &pool, &budget), true);
+		BOOST_CHECK_EQUAL(fullTree->getNodeEvaluation(), budgetTree->getNodeEvaluation());
+		BOOST_CHECK(budget.getCollapses() > 0);
+		BOOST_CHECK(budget.getPeakBytes() > 0);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(chance_sampling_test) {
+	BOOST_CHECK_THROW(ChanceSampling(0, ChanceSampling::Method::Random), std::invalid_argument);
+
+	// Stratified samples draw one polyomino in each group of consecutive ones, standing for the whole group
+	std::vector<ChanceSampling::Sample> chosen;
+	ChanceSampling stratified(3, ChanceSampling::Method::Stratified);
+	stratified.choose(42, 7, chosen);
+	BOOST_REQUIRE_EQUAL(chosen.size(), 3);
+	unsigned firsts[] = { 0, 2, 4 }, ends[] = { 2, 4, 7 };
+	for (unsigned i = 0; i < 3; i++)
+	{
+		BOOST_CHECK(chosen[i].index >= firsts[i] && chosen[i].index < ends[i]);
+		BOOST_CHECK_EQUAL(chosen[i].weight, ends[i] - firsts[i]);
+	}
+
+	// Random samples are distinct polyominos sharing the weight of all of them, only depending on the position and the round
+	ChanceSampling random(3, ChanceSampling::Method::Random, 5);
+	bool roundChangesSample(false);
+	for (std::uint64_t hash = 0; hash < 20; hash++)
+	{
+		std::vector<ChanceSampling::Sample> sameRound, otherRound;
+		random.setRound(0);
+		random.choose(hash, 7, chosen);
+		random.choose(hash, 7, sameRound);
+		random.setRound(1);
+		random.choose(hash, 7, otherRound);
+		BOOST_REQUIRE_EQUAL(chosen.size(), 3);
+		float weights(0);
+		for (unsigned i = 0; i < 3; i++)
+		{
+			BOOST_CHECK(chosen[i].index < 7);
+			BOOST_CHECK(i == 0 || chosen[i - 1].index < chosen[i].index);
+			BOOST_CHECK_EQUAL(chosen[i].index, sameRound[i].index);
+			roundChangesSample = roundChangesSample || chosen[i].index != otherRound[i].index;
+			weights += chosen[i].weight;
+		}
+		BOOST_CHECK_CLOSE(weights, 7, 0.001);
+	}
+	BOOST_CHECK(roundChangesSample);
+
+	// Without more polyominos than samples, every one of them is expanded
+	random.choose(42, 2, chosen);
+	BOOST_REQUIRE_EQUAL(chosen.size(), 2);
+	BOOST_CHECK_EQUAL(chosen[1].index, 1);
+	BOOST_CHECK_EQUAL(chosen[1].weight, 1);
+}
+
+BOOST_AUTO_TEST_CASE(decision_tree_node_chance_sampling_test) {
+	GameState initialGameState(6, 8);
+	std::vector<Polyomino> triominos(Polyomino::getPolyominosList(3));
+	MockHeuristic heuristic;
+	initialGameState.addPolyominoToQueue(&(triominos[0]));
+	int depth(3);
+
+	auto countPolyominoNodes = [](DecisionTreeNode& tree) {
+		int count(0);
+		for (auto& level : tree.getNodeStatus())
+		{
+			count += level["PolyominoNode"];
+		}
+		return count;
+	};
+
+	// Sampling as many polyominos as there are builds the full tree
+	ChanceSampling everyPolyomino(triominos.size(), ChanceSampling::Method::Random);
+	GameStateNode fullTree(initialGameState, depth, SearchContext(triominos, heuristic));
+	GameStateNode everyPolyominoTree(initialGameState, depth, SearchContext(triominos, heuristic, nullptr, nullptr, nullptr, &everyPolyomino));
+	BOOST_CHECK_EQUAL(fullTree.getNodeEvaluation(), everyPolyominoTree.getNodeEvaluation());
+	BOOST_CHECK_EQUAL(countPolyominoNodes(fullTree), countPolyominoNodes(everyPolyominoTree));
+
+	// A single sample halves the chance nodes of each layer, and the polyominos that were not sampled are built once they are known
+	ThreadPool pool(3);
+	for (auto method : { ChanceSampling::Method::Random, ChanceSampling::Method::Stratified })
+	{
+		ChanceSampling sampling(1, method, 3);
+		std::unique_ptr<DecisionTreeNode> sampledTree(std::make_unique<GameStateNode>(initialGameState, depth, SearchContext(triominos, heuristic, nullptr, nullptr, nullptr, &sampling)));
+		BOOST_CHECK_EQUAL(2 * sampledTree->getNodeStatus()[2]["PolyominoNode"], fullTree.getNodeStatus()[2]["PolyominoNode"]);
+		BOOST_CHECK(countPolyominoNodes(*sampledTree) < countPolyominoNodes(fullTree));
+		for (unsigned move = 0; move < 6; move++)
+		{
+			sampledTree = sampledTree->extractBestChild();
+			BOOST_REQUIRE(!sampledTree->isGameOver());
+			sampling.setRound(move);
+			BOOST_CHECK_NO_THROW(sampledTree->updateTree(&(triominos[move % 2]), depth, SearchContext(triominos, heuristic, nullptr, &pool, nullptr, &sampling), true));
+		}
+	}
+
+	// The mean of sampled polyominos is weighted by the number of polyominos they stand for
+	GameState emptyQueue(6, 8);
+	PolyominoNode light(emptyQueue, &(triominos[0]), 1, SearchContext(triominos, heuristic), 1), heavy(emptyQueue, &(triominos[0]), 1, SearchContext(triominos, heuristic), 3);
+	BOOST_CHECK_EQUAL(light.computeSiblingsEvaluation(10, 1), (10 + light.getNodeEvaluation()) / 2);
+	BOOST_CHECK_CLOSE(heavy.computeSiblingsEvaluation(10, 1), (10 + 3 * heavy.getNodeEvaluation()) / 4, 0.001);
+}
+
+BOOST_AUTO_TEST_CASE(decision_tree_node_lazy_expansion_test) {
+	BOOST_CHECK_THROW(LazyExpansion(0), std::invalid_argument);
+	BOOST_CHECK_THROW(LazyExpansion(4, -1), std::invalid_argument);
+
+	GameState initialGameState(6, 8);
+	std::vector<Polyomino> triominos(Polyomino::getPolyominosList(3));
+	MockHeuristic heuristic;
+	for (int i = 0; i < 3; i++)
+	{
+		initialGameState.addPolyominoToQueue(&(triominos[i % 2]));
+	}
+	int depth(3);
+	GameStateNode fullTree(initialGameState, depth, SearchContext(triominos, heuristic));
+
+	// Expanding every move builds the full tree
+	LazyExpansion everyMove(1000);
+	GameStateNode everyMoveTree(initialGameState, depth, SearchContext(triominos, heuristic, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, &everyMove));
+	BOOST_CHECK_EQUAL(fullTree.getNodeEvaluation(), everyMoveTree.getNodeEvaluation());
+	BOOST_CHECK_EQUAL(everyMove.getGeneratedMoves(), everyMove.getExpandedMoves());
+	BOOST_CHECK(everyMove.getGeneratedMoves() > 0);
+
+	// With a width of 2, the nodes of depth 2 and more keep 2 moves while the nodes of depth 1 keep all of theirs
+	LazyExpansion twoMoves(2);
+	GameStateNode twoMovesTree(initialGameState, depth, SearchContext(triominos, heuristic, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, &twoMoves));
+	BOOST_CHECK_EQUAL(twoMovesTree.getNodeStatus()[1]["GameStateNode"], 2);
+	BOOST_CHECK_EQUAL(twoMovesTree.getNodeStatus()[2]["GameStateNode"], 4);
+	BOOST_CHECK(twoMovesTree.getNodeStatus()[3]["GameStateNode"] > 4);
+	BOOST_CHECK_EQUAL(twoMoves.getExpandedMoves(), 2 + 2 * 2);
+	BOOST_CHECK(twoMoves.getGeneratedMoves() > twoMoves.getExpandedMoves());
+	BOOST_CHECK(twoMovesTree.getNodeEvaluation() <= fullTree.getNodeEvaluation());
+
+	// The layer of leaves built by each update is selected by the next update
+	std::unique_ptr<DecisionTreeNode> updatedTree(std::make_unique<GameStateNode>(initialGameState, depth, SearchContext(triominos, heuristic, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, &twoMoves)));
+	for (int move = 0; move < 3; move++)
+	{
+		updatedTree = updatedTree->extractBestChild();
+		updatedTree->updateTree(&(triominos[move % 2]), depth, SearchContext(triominos, heuristic, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, &twoMoves), false);
+		// Moves leading to a game over have no subtree: the tree may be shallower than the depth
+		DecisionTreeNode::NodeStatus status(updatedTree->getNodeStatus());
+		for (unsigned level = 1; level < status.size() && level < 3; level++)
+		{
+			BOOST_CHECK(status[level]["GameStateNode"] <= (1 << level));
+		}
+	}
+
+	// The best move on its own is always expanded, along with the moves evaluated as well as it with no margin
+	LazyExpansion noMargin(1000, 0);
+	GameStateNode noMarginTree(initialGameState, depth, SearchContext(triominos, heuristic, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, &noMargin));
+	BOOST_CHECK(noMargin.getExpandedMoves() >= 2); // At least the best move of the root and of the node of depth 2 below it
+	BOOST_CHECK(noMargin.getExpandedMoves() < noMargin.getGeneratedMoves());
+	twoMoves.resetStatistics();
+	BOOST_CHECK_EQUAL(twoMoves.getGeneratedMoves(), 0);
+}
@@ -0,0 +1,111 @@
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include "ExpectimaxStrategy.h"
+#include "DellacherieHeuristic.h"
+#include "StrategyTestHelpers.h"
+
+using namespace TetrisAI;
+
+namespace {
+
+	/// <summary>Plays a game with an expectimax search and checks every decision against a tree of nodes built from scratch</summary>
+	/// <returns>Statistics of the search at the end of the game</returns>
+	ExpectimaxStrategy::Statistics checkAgainstNodeTree(short width, short height, unsigned squares, unsigned stepsAhead, unsigned depth, unsigned moves, bool usePruning)
+	{
+		DellacherieHeuristic heuristic;
+		return TetrisAI::checkAgainstNodeTree<ExpectimaxStrategy>(heuristic, [&heuristic, usePruning](unsigned depth) { return std::make_unique<ExpectimaxStrategy>(heuristic, depth, usePruning); },
+			width, height, squares, stepsAhead, depth, moves, 5)->getStatistics();
+	}
+}
+
+BOOST_AUTO_TEST_CASE(expectimax_strategy_test) {
+	DellacherieHeuristic heuristic;
+	BOOST_CHECK_THROW(ExpectimaxStrategy(heuristic, ExpectimaxStrategy::maxDepth + 1), std::invalid_argument);
+
+	ExpectimaxStrategy::Statistics exhaustive(checkAgainstNodeTree(6, 10, 3, 0, 2, 30, false));
+	BOOST_CHECK_EQUAL(exhaustive.cutoffs, 0);
+	BOOST_CHECK_EQUAL(exhaustive.prunedSubtrees, 0);
+	checkAgainstNodeTree(6, 10, 3, 1, 3, 15, false);
+}
+
+BOOST_AUTO_TEST_CASE(expectimax_strategy_pruning_test) {
+	// Pruning must take the same decisions while searching fewer nodes
+	ExpectimaxStrategy::Statistics exhaustive(checkAgainstNodeTree(8, 12, 4, 0, 3, 10, false));
+	ExpectimaxStrategy::Statistics pruned(checkAgainstNodeTree(8, 12, 4, 0, 3, 10, true));
+	BOOST_CHECK(pruned.cutoffs > 0);
+	BOOST_CHECK(pruned.prunedSubtrees >= pruned.cutoffs);
+	BOOST_CHECK(pruned.searchedNodes < exhaustive.searchedNodes);
+	BOOST_CHECK(pruned.evaluatedNodes < exhaustive.evaluatedNodes);
+
+	checkAgainstNodeTree(6, 10, 3, 0, 2, 30, true);
+	checkAgainstNodeTree(6, 10, 3, 1, 3, 15, true);
+	checkAgainstNodeTree(8, 12, 4, 2, 3, 10, true);
+}
+
+BOOST_AUTO_TEST_CASE(dellacherie_heuristic_bounds_test) {
+	// Every game state reached by a random game must be evaluated within the bounds, as must its branch evaluations
+	std::mt19937 generator(11);
+	std::vector<Polyomino> polyominos(Polyomino::getPolyominosList(4));
+	DellacherieHeuristic heuristic;
+	GameState gameState(6, 12);
+	Heuristic::Bounds bounds;
+	BOOST_REQUIRE(heuristic.getEvaluationBounds(gameState, 1, 4, bounds));
+	BOOST_CHECK(bounds.lower <= Heuristic::gameOverEvaluation);
+
+	while (!gameState.isGameOver())
+	{
+		gameState.addPolyominoToQueue(&polyominos[generator() % polyominos.size()]);
+		std::vector<Placement> placements(gameState.getGrid().computePlacements(*gameState.polyominoQueueHead()));
+		gameState.play(placements[generator() % placements.size()]);
+
+		float evaluation(heuristic.evaluate(gameState));
+		BOOST_CHECK(evaluation >= bounds.lower && evaluation <= bounds.upper);
+		float branchEvaluation(heuristic.evaluateBranch(gameState, evaluation));
+		BOOST_CHECK(branchEvaluation >= bounds.lower && branchEvaluation <= bounds.upper);
+		BOOST_CHECK_EQUAL(heuristic.invertBranch(gameState, branchEvaluation), evaluation);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(expectimax_strategy_time_budget_test) {
+	// A search out of time keeps the decision of a single move, one with plenty of time completes every depth
+	std::mt19937 generator(9);
+	std::vector<Polyomino> polyominos(Polyomino::getPolyominosList(4));
+	DellacherieHeuristic heuristic;
+	ExpectimaxStrategy singleMove(heuristic, 1), exhaustive(heuristic, 3);
+	ExpectimaxStrategy shortBudget(heuristic, 3, true, std::chrono::microseconds(1));
+	ExpectimaxStrategy longBudget(heuristic, 3, true, std::chrono::hours(1));
+
+	GameState gameState(8, 12);
+	for (unsigned move = 0; move < 10; move++)
+	{
+		gameState.addPolyominoToQueue(&polyominos[generator() % polyominos.size()]);
+		Transformation singleMoveDecision(singleMove.decideMove(gameState, polyominos));
+		Transformation shortBudgetDecision(shortBudget.decideMove(gameState, polyominos));
+		BOOST_CHECK_EQUAL(shortBudget.getLastDepth(), 1);
+		BOOST_CHECK_EQUAL(shortBudgetDecision.translation, singleMoveDecision.translation);
+		BOOST_CHECK_EQUAL(shortBudgetDecision.rotation, singleMoveDecision.rotation);
+
+		Transformation decision(exhaustive.decideMove(gameState, polyominos));
+		Transformation longBudgetDecision(longBudget.decideMove(gameState, polyominos));
+		BOOST_CHECK_EQUAL(longBudget.getLastDepth(), 3);
+		BOOST_CHECK_EQUAL(longBudgetDecision.translation, decision.translation);
+		BOOST_CHECK_EQUAL(longBudgetDecision.rotation, decision.rotation);
+		if (decision.translation == -1)
+		{
+			break;
+		}
+		gameState.play(decision);
+	}
+	BOOST_CHECK(shortBudget.getStatistics().abortedSearches > 0);
+	BOOST_CHECK_EQUAL(longBudget.getStatistics().abortedSearches, 0);
+
+	// Deeper searches than a decision tree allows are deepened as far as the budget goes
+	ExpectimaxStrategy deepSearch(heuristic, ExpectimaxStrategy::maxDepth, true, std::chrono::milliseconds(20));
+	GameState deepGameState(8, 12);
+	deepGameState.addPolyominoToQueue(&polyominos[0]);
+	BOOST_CHECK(deepSearch.decideMove(deepGameState, polyominos).translation != -1);
+	BOOST_CHECK(deepSearch.getLastDepth() >= 1 && deepSearch.getLastDepth() < ExpectimaxStrategy::maxDepth);
+	BOOST_CHECK_EQUAL(deepSearch.getStatistics().abortedSearches, 1);
+}
@@ -0,0 +1,46 @@
+#include <boost/test/unit_test.hpp>
+#include <stdexcept>
+#include "FlatTreeStrategy.h"
+#include "DellacherieHeuristic.h"
+#include "StrategyTestHelpers.h"
+
+using namespace TetrisAI;
+
+namespace {
+
+	/// <summary>Returns the number of nodes of a tree (a PolyominoNode is reported without its sub root, which a flat tree does not store apart either)</summary>
+	int countNodes(DecisionTreeNode& node)
+	{
+		int count(0);
+		for (auto& level : node.getNodeStatus())
+		{
+			for (auto& kv : level)
+			{
+				count += kv.second;
+			}
+		}
+		return count;
+	}
+
+	/// <summary>Plays a game with a flat tree and checks every decision against a tree of nodes built from scratch</summary>
+	void checkAgainstNodeTree(short width, short height, unsigned squares, unsigned stepsAhead, unsigned depth, unsigned moves)
+	{
+		DellacherieHeuristic heuristic;
+		TetrisAI::checkAgainstNodeTree<FlatTreeStrategy>(heuristic, [&heuristic](unsigned depth) { return std::make_unique<FlatTreeStrategy>(heuristic, depth); },
+			width, height, squares, stepsAhead, depth, moves, 3, [](FlatTreeStrategy& strategy, DecisionTreeNode& bestChild) {
+				// The flat tree kept the subtree of the chosen move: it must be the one the node tree built
+				BOOST_CHECK_EQUAL(strategy.getNodeCount(), countNodes(bestChild));
+			});
+	}
+}
+
+BOOST_AUTO_TEST_CASE(flat_tree_strategy_test) {
+	DellacherieHeuristic heuristic;
+	BOOST_CHECK_THROW(FlatTreeStrategy(heuristic, FlatTreeStrategy::maxDepth + 1), std::invalid_argument);
+
+	checkAgainstNodeTree(6, 10, 3, 0, 1, 30);
+	checkAgainstNodeTree(6, 10, 3, 0, 2, 30);
+	checkAgainstNodeTree(6, 10, 3, 1, 2, 30);
+	checkAgainstNodeTree(6, 10, 3, 1, 3, 15);
+	checkAgainstNodeTree(8, 12, 4, 2, 3, 10);
+}
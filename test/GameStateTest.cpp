@@ -0,0 +1,59 @@
+#include <boost/test/unit_test.hpp>
+#include "GameState.h"
+#include "Polyomino.h"
+#include <vector>
+#include <stdexcept>
+
+using namespace TetrisAI;
+
+BOOST_AUTO_TEST_CASE(gamestate_hash_test) {
+	Polyomino l({ 3, 1 }), i({ 7 });
+	GameState gs1(6, 6), gs2(6, 6);
+	BOOST_CHECK_EQUAL(gs1.getHash(), gs2.getHash());
+
+	// The hash depends on the known polyominos and their order
+	gs1.addPolyominoToQueue(&l);
+	BOOST_CHECK(gs1.getHash() != gs2.getHash());
+	gs2.addPolyominoToQueue(&i);
+	BOOST_CHECK(gs1.getHash() != gs2.getHash());
+	gs1.addPolyominoToQueue(&i);
+	gs2.addPolyominoToQueue(&l);
+	BOOST_CHECK(gs1.getHash() != gs2.getHash());
+
+	// Playing the same blocks in a different order leads to the same position
+	gs1.play(Transformation(0, 0));
+	gs1.play(Transformation(3, 0));
+	gs2.play(Transformation(3, 0));
+	gs2.play(Transformation(0, 0));
+	BOOST_CHECK(gs1.getGridContent() == gs2.getGridContent());
+	BOOST_CHECK_EQUAL(gs1.getHash(), gs2.getHash());
+
+	GameState copy(gs1);
+	BOOST_CHECK_EQUAL(gs1.getHash(), copy.getHash());
+	copy.addPolyominoToQueue(&l);
+	BOOST_CHECK(gs1.getHash() != copy.getHash());
+}
+BOOST_AUTO_TEST_CASE(gamestate_queue_test) {
+	// Polyominos are queued by id: copies of the same polyomino are interchangeable
+	std::vector<Polyomino> list1(Polyomino::getPolyominosList(3)), list2(Polyomino::getPolyominosList(3));
+	GameState gs1(6, 6), gs2(6, 6);
+	gs1.addPolyominoToQueue(&list1[1]);
+	gs2.addPolyominoToQueue(&list2[1]);
+	BOOST_CHECK_EQUAL(gs1.getHash(), gs2.getHash());
+	BOOST_CHECK_EQUAL(gs1.polyominoQueueHead(), &Polyomino::fromId(list1[1].getId()));
+
+	for (int index = 1; index < GameState::maxQueueSize; index++)
+	{
+		gs1.addPolyominoToQueue(list1[0].getId());
+	}
+	BOOST_CHECK(gs1.getPolyominoQueueSize() == GameState::maxQueueSize);
+	BOOST_CHECK_THROW(gs1.addPolyominoToQueue(&list1[0]), std::invalid_argument);
+	BOOST_CHECK_EQUAL(gs1.polyominoQueueTail()->getId(), list1[0].getId());
+
+	GameState copy(gs1);
+	copy.play(Transformation(0, 0));
+	BOOST_CHECK_EQUAL(copy.getPlayedPolyomino()->getId(), list1[1].getId());
+	BOOST_CHECK_EQUAL(copy.getPolyominoQueueSize() + 1, gs1.getPolyominoQueueSize());
+	BOOST_CHECK_EQUAL(copy.polyominoQueueHead()->getId(), list1[0].getId());
+	BOOST_CHECK(gs1.getPolyominoQueueSize() == GameState::maxQueueSize);
+}
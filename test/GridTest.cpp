@@ -1,7 +1,11 @@
 #include <boost/test/unit_test.hpp>
 #include "Grid.h"
 #include "Polyomino.h"
+#include "BitKernels.h"
 #include <vector>
+#include <random>
+#include <map>
+#include <set>
 
 using namespace TetrisAI;
 
@@ -10,6 +14,26 @@ std::vector<Polyomino> getTriominos() {
 	return std::vector<Polyomino>({ p1, p2 });
 }
 
+// Returns the move that keeps the grid the lowest (ties being broken randomly) so that long sequences of moves clear lines regularly
+Transformation getLowestMove(const Grid& g, const Polyomino& polyomino, std::mt19937& generator) {
+	Transformation t, bestMove;
+	int bestScore(-1);
+	for (t.rotation = 0; t.rotation < polyomino.getRotationCount(); t.rotation++)
+	{
+		for (t.translation = 0; t.translation <= g.getWidth() - polyomino.getRotatedPiece(t.rotation).getWidth(); t.translation++)
+		{
+			Grid copy(g);
+			int score(copy.fitPiece(polyomino, t).gameOver ? 100000 : copy.getTopHeight() * 100 + generator() % 100);
+			if (bestScore == -1 || score < bestScore)
+			{
+				bestScore = score;
+				bestMove = t;
+			}
+		}
+	}
+	return bestMove;
+}
+
 BOOST_AUTO_TEST_CASE(grid_constructors_test) {
 	// Testing basic initialization
 	Grid g(10, 20);
@@ -19,17 +43,22 @@ BOOST_AUTO_TEST_CASE(grid_constructors_test) {
 	BOOST_CHECK_EQUAL(0, g.getContent()[0]);
 	BOOST_CHECK_EQUAL(0, g.getContent()[19]);
 
-	// Sizes should be between 4 and 32 for both height and width
+	// Sizes should be at least 4, the width can't exceed the number of bits of a row and the height can't exceed 32
 	BOOST_CHECK_THROW(Grid(4, 1), std::invalid_argument);
 	BOOST_CHECK_THROW(Grid(1, 4), std::invalid_argument);
 	BOOST_CHECK_THROW(Grid(4, 33), std::invalid_argument);
-	BOOST_CHECK_THROW(Grid(33, 4), std::invalid_argument);
+	BOOST_CHECK_THROW(Grid(Grid::maxWidth + 1, 4), std::invalid_argument);
+
+	// The widest grid has a complete line with every bit of a row set
+	Grid widest(Grid::maxWidth, 4);
+	BOOST_CHECK(widest.getCompleteLine() == static_cast<Row>(~Row(0)));
+	BOOST_CHECK_EQUAL(Grid(10, 4).getCompleteLine(), 1023);
 }
 
 BOOST_AUTO_TEST_CASE(grid_fitPiece_test) {
 	Grid g(6, 6); // Create a small grid 6x6
 	std::vector<Polyomino> triominos(getTriominos());
-	std::vector<unsigned int> gridContent, expectedContent;
+	std::vector<Row> gridContent, expectedContent;
 	MoveResult lastMove, expectedMove;
 
 	g.fitPiece(triominos[0], Transformation(0, 0));
@@ -40,7 +69,7 @@ BOOST_AUTO_TEST_CASE(grid_fitPiece_test) {
 	1.	---x-x
 	0.	---xxx
 	*/
-	expectedContent = std::vector<unsigned int>({ 7, 5, 4, 0, 0, 0 });
+	expectedContent = std::vector<Row>({ 7, 5, 4, 0, 0, 0 });
 	gridContent = g.getContent();
 	BOOST_CHECK_EQUAL_COLLECTIONS(expectedContent.begin(), expectedContent.end(), gridContent.begin(), gridContent.end());
 	BOOST_CHECK(lastMove == expectedMove);
@@ -53,7 +82,7 @@ BOOST_AUTO_TEST_CASE(grid_fitPiece_test) {
 	1.	---x--
 	0.	---x-x
 	*/
-	expectedContent = std::vector<unsigned int>({ 5, 4, 0, 0, 0, 0 });
+	expectedContent = std::vector<Row>({ 5, 4, 0, 0, 0, 0 });
 	gridContent = g.getContent();
 	BOOST_CHECK_EQUAL_COLLECTIONS(expectedContent.begin(), expectedContent.end(), gridContent.begin(), gridContent.end());
 	BOOST_CHECK(lastMove == expectedMove);
@@ -66,7 +95,7 @@ BOOST_AUTO_TEST_CASE(grid_fitPiece_test) {
 	1.	xx-x--
 	0.	x--x-x
 	*/
-	expectedContent = std::vector<unsigned int>({ 37, 52, 0, 0, 0, 0 });
+	expectedContent = std::vector<Row>({ 37, 52, 0, 0, 0, 0 });
 	gridContent = g.getContent();
 	BOOST_CHECK_EQUAL_COLLECTIONS(expectedContent.begin(), expectedContent.end(), gridContent.begin(), gridContent.end());
 	BOOST_CHECK(lastMove == expectedMove);
@@ -82,7 +111,7 @@ BOOST_AUTO_TEST_CASE(grid_fitPiece_test) {
 	1.	xx-x--
 	0.	x--x-x
 	*/
-	expectedContent = std::vector<unsigned int>({ 37, 52, 32, 32, 32, 0 });
+	expectedContent = std::vector<Row>({ 37, 52, 32, 32, 32, 0 });
 	gridContent = g.getContent();
 	BOOST_CHECK_EQUAL_COLLECTIONS(expectedContent.begin(), expectedContent.end(), gridContent.begin(), gridContent.end());
 	BOOST_CHECK(lastMove == expectedMove);
@@ -107,6 +136,59 @@ BOOST_AUTO_TEST_CASE(grid_fitPiece_test) {
 	BOOST_CHECK_THROW(g.fitPiece(triominos[0], Transformation(4, 0)), std::invalid_argument);
 	BOOST_CHECK_THROW(g.fitPiece(triominos[0], Transformation(6, 1)), std::invalid_argument);
 	BOOST_CHECK_THROW(g.fitPiece(triominos[1], Transformation(5, 0)), std::invalid_argument);
+	BOOST_CHECK_THROW(g.fitPiece(triominos[1], Transformation(-1, 0)), std::invalid_argument);
+	BOOST_CHECK_THROW(g.fitPiece(triominos[0], triominos[0].getPlacedPiecesCount()), std::invalid_argument);
+	BOOST_CHECK_THROW(g.fitPiece(triominos[0], triominos[0].getPlacedPieceIndex(Transformation(3, 0))), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(grid_columnHeights_test) {
+	Grid g(6, 6); // Create a small grid 6x6
+	std::vector<Polyomino> triominos(getTriominos());
+
+	for (int col = 0; col < 6; col++)
+	{
+		BOOST_CHECK_EQUAL(0, g.getColumnHeight(col));
+	}
+
+	g.fitPiece(triominos[0], Transformation(0, 0));
+	g.fitPiece(triominos[1], Transformation(2, 1));
+	/* Grid last three rows:
+	2.	---x--
+	1.	---x-x
+	0.	---xxx
+	*/
+	std::vector<int> expectedHeights({ 2, 1, 3, 0, 0, 0 });
+	for (int col = 0; col < 6; col++)
+	{
+		BOOST_CHECK_EQUAL(expectedHeights[col], g.getColumnHeight(col));
+	}
+
+	g.fitPiece(triominos[1], Transformation(3, 0));
+	/* Grid last three rows (the bottom row was cleared, column 1 is now empty):
+	2.	------
+	1.	---x--
+	0.	---x-x
+	*/
+	expectedHeights = std::vector<int>({ 1, 0, 2, 0, 0, 0 });
+	for (int col = 0; col < 6; col++)
+	{
+		BOOST_CHECK_EQUAL(expectedHeights[col], g.getColumnHeight(col));
+	}
+
+	g.fitPiece(triominos[0], Transformation(4, 2));
+	g.fitPiece(triominos[1], Transformation(5, 1));
+	/* Grid expected content:
+	4.	x-----
+	3.	x-----
+	2.	x-----
+	1.	xx-x--
+	0.	x--x-x
+	*/
+	expectedHeights = std::vector<int>({ 1, 0, 2, 0, 2, 5 });
+	for (int col = 0; col < 6; col++)
+	{
+		BOOST_CHECK_EQUAL(expectedHeights[col], g.getColumnHeight(col));
+	}
 }
 
 BOOST_AUTO_TEST_CASE(grid_columnTransitions_test) {
@@ -236,4 +318,163 @@ BOOST_AUTO_TEST_CASE(grid_emptyBlocksDown_test) {
 	BOOST_CHECK_EQUAL(0, g.emptyBlocksDown(2, 0));
 	BOOST_CHECK_EQUAL(2, g.emptyBlocksDown(1, 0));
 	BOOST_CHECK_EQUAL(1, g.emptyBlocksDown(1, 2));
-}
\ No newline at end of file
+}
+
+BOOST_AUTO_TEST_CASE(grid_column_layout_test) {
+	// Both layouts must describe the same grid and output the same features whatever the moves played
+	Grid rowMajor(10, 20), dualLayout(10, 20, Grid::Layout::RowAndColumnMajor);
+	std::vector<Polyomino> tetrominos(Polyomino::getPolyominosList(4));
+	std::mt19937 generator(42);
+	BOOST_CHECK(dualLayout.getLayout() == Grid::Layout::RowAndColumnMajor);
+
+	int linesCleared(0);
+	for (int move = 0; move < 200; move++)
+	{
+		const Polyomino& polyomino(tetrominos[generator() % tetrominos.size()]);
+		Transformation t(getLowestMove(rowMajor, polyomino, generator));
+
+		MoveResult expectedResult(rowMajor.fitPiece(polyomino, t));
+		BOOST_CHECK(dualLayout.fitPiece(polyomino, t) == expectedResult);
+		if (expectedResult.gameOver)
+		{
+			break;
+		}
+		linesCleared += expectedResult.linesCleared;
+
+		std::vector<Row> expectedContent(rowMajor.getContent()), content(dualLayout.getContent());
+		BOOST_CHECK_EQUAL_COLLECTIONS(expectedContent.begin(), expectedContent.end(), content.begin(), content.end());
+		BOOST_CHECK_EQUAL(rowMajor.cellars(), dualLayout.cellars());
+		BOOST_CHECK_EQUAL(rowMajor.wells(), dualLayout.wells());
+		BOOST_CHECK_EQUAL(rowMajor.getTopHeight(), dualLayout.getTopHeight());
+		for (int col = 0; col < 10; col++)
+		{
+			BOOST_CHECK_EQUAL(rowMajor.getColumnHeight(col), dualLayout.getColumnHeight(col));
+			for (int row = -1; row < 20; row++)
+			{
+				BOOST_CHECK_EQUAL(rowMajor.emptyBlocksDown(row, col), dualLayout.emptyBlocksDown(row, col));
+			}
+		}
+	}
+	BOOST_CHECK(linesCleared > 0); // Make sure the removal of rows was covered
+}
+BOOST_AUTO_TEST_CASE(grid_computePlacements_test) {
+	// Each placement must announce exactly what playing its transformation produces, and playing it must give the same grid
+	Grid g(8, 12);
+	std::vector<Polyomino> tetrominos(Polyomino::getPolyominosList(4));
+	std::mt19937 generator(7);
+
+	for (int move = 0; move < 100; move++)
+	{
+		const Polyomino& polyomino(tetrominos[generator() % tetrominos.size()]);
+		std::vector<Placement> placements(g.computePlacements(polyomino));
+
+		unsigned expectedCount(0);
+		for (int rotation = 0; rotation < polyomino.getRotationCount(); rotation++)
+		{
+			expectedCount += g.getWidth() - polyomino.getRotatedPiece(rotation).getWidth() + 1;
+		}
+		BOOST_REQUIRE_EQUAL(expectedCount, placements.size());
+
+		for (auto& placement : placements)
+		{
+			Grid expectedGrid(g), placedGrid(g);
+			MoveResult expectedResult(expectedGrid.fitPiece(polyomino, placement.transformation));
+			BOOST_CHECK(placement.result == expectedResult);
+			BOOST_CHECK(placedGrid.fitPiece(polyomino, placement) == expectedResult);
+			BOOST_CHECK_EQUAL(placement.placedPieceIndex, polyomino.getPlacedPieceIndex(placement.transformation));
+
+			std::vector<Row> expectedContent(expectedGrid.getContent()), content(placedGrid.getContent());
+			BOOST_CHECK_EQUAL_COLLECTIONS(expectedContent.begin(), expectedContent.end(), content.begin(), content.end());
+
+			Grid indexedGrid(g);
+			BOOST_CHECK(indexedGrid.fitPiece(polyomino, placement.placedPieceIndex) == expectedResult);
+			content = indexedGrid.getContent();
+			BOOST_CHECK_EQUAL_COLLECTIONS(expectedContent.begin(), expectedContent.end(), content.begin(), content.end());
+		}
+
+		if (g.fitPiece(polyomino, getLowestMove(g, polyomino, generator)).gameOver)
+		{
+			break;
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(grid_cached_features_test) {
+	// Features updated by fitPiece must match the ones computed from scratch on the whole grid
+	Grid g(10, 16);
+	std::vector<Polyomino> tetrominos(Polyomino::getPolyominosList(4));
+	std::mt19937 generator(3);
+	const BitKernels& kernels(BitKernels::portable());
+
+	int linesCleared(0);
+	for (int move = 0; move < 300; move++)
+	{
+		const Polyomino& polyomino(tetrominos[generator() % tetrominos.size()]);
+		MoveResult result(g.fitPiece(polyomino, getLowestMove(g, polyomino, generator)));
+		if (result.gameOver)
+		{
+			break;
+		}
+		linesCleared += result.linesCleared;
+
+		std::vector<Row> content(g.getContent());
+		int expectedCellars(0);
+		for (int col = 0; col < g.getWidth(); col++)
+		{
+			for (int row = 0; row < g.getColumnHeight(col); row++)
+			{
+				expectedCellars += !((content[row] >> col) & 1);
+			}
+		}
+
+		BOOST_CHECK_EQUAL(kernels.columnTransitions(content.data(), g.getTopHeight(), g.getWidth()), g.columnTransitions());
+		BOOST_CHECK_EQUAL(kernels.rowTransitions(content.data(), g.getTopHeight(), g.getWidth()), g.rowTransitions());
+		BOOST_CHECK_EQUAL(expectedCellars, g.cellars());
+	}
+	BOOST_CHECK(linesCleared > 0);
+}
+
+BOOST_AUTO_TEST_CASE(grid_hash_test) {
+	// Grids with the same blocks must have the same hash whatever the moves (and cleared lines) that produced them
+	// Small grids and random moves make the same grids appear many times through different sequences
+	std::vector<Polyomino> triominos(getTriominos());
+	std::map<std::vector<Row>, std::uint64_t> knownHashes;
+	std::mt19937 generator(11);
+	BOOST_CHECK_EQUAL(0, Grid(4, 6).getHash());
+
+	int sameGrids(0), linesCleared(0);
+	for (int game = 0; game < 200; game++)
+	{
+		Grid g(4, 6);
+		for (int move = 0; move < 20; move++)
+		{
+			const Polyomino& polyomino(triominos[generator() % triominos.size()]);
+			Transformation t;
+			t.rotation = generator() % polyomino.getRotationCount();
+			t.translation = generator() % (g.getWidth() - polyomino.getRotatedPiece(t.rotation).getWidth() + 1);
+			MoveResult result(g.fitPiece(polyomino, t));
+			if (result.gameOver)
+			{
+				break;
+			}
+			linesCleared += result.linesCleared;
+
+			auto known(knownHashes.insert(std::make_pair(g.getContent(), g.getHash())));
+			if (!known.second)
+			{
+				sameGrids++;
+				BOOST_CHECK_EQUAL(known.first->second, g.getHash());
+			}
+		}
+	}
+	BOOST_CHECK(sameGrids > 0);
+	BOOST_CHECK(linesCleared > 0);
+
+	// Different grids should not share a hash
+	std::set<std::uint64_t> distinctHashes;
+	for (auto& known : knownHashes)
+	{
+		distinctHashes.insert(known.second);
+	}
+	BOOST_CHECK_EQUAL(knownHashes.size(), distinctHashes.size());
+}
@@ -0,0 +1,43 @@
+#include <boost/test/unit_test.hpp>
+#include <random>
+#include "HeuristicStrategy.h"
+#include "DellacherieHeuristic.h"
+
+using namespace TetrisAI;
+
+BOOST_AUTO_TEST_CASE(heuristic_strategy_pondering_test) {
+	// Whether the pondering completes or is cancelled early, the subtree it leaves gives the decisions of the strategy without pondering
+	std::vector<Polyomino> tetrominos(Polyomino::getPolyominosList(4));
+	DellacherieHeuristic heuristic;
+	unsigned depth(2);
+	HeuristicStrategy strategy(heuristic, depth, false), pondering(heuristic, depth, false, nullptr, 0, nullptr, true), pooledPondering(heuristic, depth, true, nullptr, 0, nullptr, true);
+
+	std::mt19937 generator(11);
+	GameState gameState(8, 12);
+	for (unsigned move = 0; move < 10; move++)
+	{
+		gameState.addPolyominoToQueue(&tetrominos[generator() % tetrominos.size()]);
+		Transformation decision(strategy.decideMove(gameState, tetrominos));
+		for (HeuristicStrategy* ponderingStrategy : { &pondering, &pooledPondering })
+		{
+			Transformation ponderedDecision(ponderingStrategy->decideMove(gameState, tetrominos));
+			BOOST_CHECK_EQUAL(decision.translation, ponderedDecision.translation);
+			BOOST_CHECK_EQUAL(decision.rotation, ponderedDecision.rotation);
+		}
+		if (move % 2 == 1)
+		{
+			BOOST_CHECK(pondering.getLastPondering().completed);
+			BOOST_CHECK(pondering.getLastPondering().seconds > 0);
+		}
+		BOOST_REQUIRE(decision.translation != -1);
+		gameState.play(decision);
+
+		// The pondering is left to complete after even moves while the next decision cancels it after odd ones
+		if (move % 2 == 0)
+		{
+			pondering.waitPondering();
+			pooledPondering.waitPondering();
+		}
+	}
+	BOOST_CHECK(!strategy.getLastPondering().completed);
+}
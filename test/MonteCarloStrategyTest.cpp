@@ -0,0 +1,74 @@
+#include <boost/test/unit_test.hpp>
+#include <random>
+#include <stdexcept>
+#include "MonteCarloStrategy.h"
+#include "GameStateNode.h"
+#include "DellacherieHeuristic.h"
+
+using namespace TetrisAI;
+
+BOOST_AUTO_TEST_CASE(monte_carlo_strategy_test) {
+	DellacherieHeuristic heuristic;
+	BOOST_CHECK_THROW(MonteCarloStrategy(heuristic, 100, MonteCarloStrategy::maxDepth + 1), std::invalid_argument);
+	BOOST_CHECK_THROW(MonteCarloStrategy(heuristic, 100, 4, 0), std::invalid_argument);
+	BOOST_CHECK_THROW(MonteCarloStrategy(heuristic, 0, 4), std::invalid_argument);
+
+	// With one rollout per move of the coming polyomino and rollouts playing no move, each move is evaluated once: the decision is the one of a tree of depth 1
+	std::mt19937 generator(3);
+	std::vector<Polyomino> polyominos(Polyomino::getPolyominosList(4));
+	GameState gameState(8, 12);
+	for (unsigned move = 0; move < 20; move++)
+	{
+		gameState.addPolyominoToQueue(&polyominos[generator() % polyominos.size()]);
+		std::unique_ptr<DecisionTreeNode> bestChild(GameStateNode(gameState, 1, polyominos, heuristic).extractBestChild());
+
+		unsigned placementsCount(gameState.getGrid().computePlacements(*gameState.polyominoQueueHead()).size());
+		MonteCarloStrategy strategy(heuristic, placementsCount, 0);
+		Transformation decision(strategy.decideMove(gameState, polyominos));
+
+		// Fewer rollouts than moves still visit each move once
+		MonteCarloStrategy singleRollout(heuristic, 1, 0);
+		Transformation singleRolloutDecision(singleRollout.decideMove(gameState, polyominos));
+		BOOST_CHECK_EQUAL(singleRollout.getStatistics().rollouts, placementsCount);
+		BOOST_CHECK_EQUAL(singleRolloutDecision.translation, decision.translation);
+		BOOST_CHECK_EQUAL(singleRolloutDecision.rotation, decision.rotation);
+		if (bestChild->isGameOver())
+		{
+			BOOST_CHECK_EQUAL(decision.translation, -1);
+			return;
+		}
+		BOOST_CHECK_EQUAL(decision.translation, bestChild->getPolyominoMove().translation);
+		BOOST_CHECK_EQUAL(decision.rotation, bestChild->getPolyominoMove().rotation);
+		gameState.play(decision);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(monte_carlo_strategy_parallel_test) {
+	// Trees grown by several threads only depend on the seed, and every rollout is done
+	std::vector<Polyomino> polyominos(Polyomino::getPolyominosList(4));
+	DellacherieHeuristic heuristic;
+	unsigned rollouts(300), moves(15);
+	MonteCarloStrategy strategy(heuristic, rollouts, 6, 3, std::chrono::microseconds::zero(), 7), sameSeed(heuristic, rollouts, 6, 3, std::chrono::microseconds::zero(), 7);
+
+	std::mt19937 generator(5);
+	GameState gameState(10, 20);
+	for (unsigned move = 0; move < moves; move++)
+	{
+		gameState.addPolyominoToQueue(&polyominos[generator() % polyominos.size()]);
+		Transformation decision(strategy.decideMove(gameState, polyominos));
+		Transformation sameSeedDecision(sameSeed.decideMove(gameState, polyominos));
+		BOOST_REQUIRE(decision.translation != -1);
+		BOOST_CHECK_EQUAL(decision.translation, sameSeedDecision.translation);
+		BOOST_CHECK_EQUAL(decision.rotation, sameSeedDecision.rotation);
+		gameState.play(decision);
+	}
+	BOOST_CHECK_EQUAL(strategy.getStatistics().rollouts, moves * rollouts);
+	BOOST_CHECK(strategy.getStatistics().treeNodes > moves);
+
+	// With a time budget only, rollouts go on until it is spent
+	MonteCarloStrategy timedStrategy(heuristic, 0, 6, 2, std::chrono::milliseconds(5));
+	gameState.addPolyominoToQueue(&polyominos[0]);
+	Transformation decision(timedStrategy.decideMove(gameState, polyominos));
+	BOOST_CHECK(decision.translation != -1);
+	BOOST_CHECK(timedStrategy.getStatistics().rollouts >= 2);
+}
@@ -0,0 +1,88 @@
+#include <boost/test/unit_test.hpp>
+#include "NodePool.h"
+#include <thread>
+#include <vector>
+
+using namespace TetrisAI;
+
+namespace {
+	struct PooledNode {
+		double values[4];
+	};
+
+	using Pool = NodePool<PooledNode>;
+}
+
+BOOST_AUTO_TEST_CASE(node_pool_test) {
+	std::size_t reserved(Pool::getReservedNodes());
+
+	// A freed node is handed out again by the next allocation of the same thread
+	void* first(Pool::allocate(sizeof(PooledNode)));
+	void* second(Pool::allocate(sizeof(PooledNode)));
+	BOOST_CHECK(first != second);
+	BOOST_CHECK_EQUAL(Pool::getReservedNodes(), reserved + Pool::nodesPerSlab);
+	Pool::deallocate(first, sizeof(PooledNode));
+	BOOST_CHECK(Pool::allocate(sizeof(PooledNode)) == first);
+	Pool::deallocate(first, sizeof(PooledNode));
+	Pool::deallocate(second, sizeof(PooledNode));
+	Pool::deallocate(nullptr, sizeof(PooledNode));
+
+	// Other sizes are not taken from the slabs
+	void* larger(Pool::allocate(2 * sizeof(PooledNode)));
+	Pool::deallocate(larger, 2 * sizeof(PooledNode));
+	BOOST_CHECK_EQUAL(Pool::getReservedNodes(), reserved + Pool::nodesPerSlab);
+}
+
+BOOST_AUTO_TEST_CASE(node_pool_threads_test) {
+	// Nodes built by a thread and freed by another one must be reusable by the next threads instead of reserving new slabs
+	std::vector<void*> nodes(4 * Pool::nodesPerSlab);
+	std::thread builder([&nodes]() {
+		for (auto& node : nodes)
+		{
+			node = Pool::allocate(sizeof(PooledNode));
+		}
+	});
+	builder.join();
+	std::size_t reserved(Pool::getReservedNodes());
+
+	for (auto node : nodes)
+	{
+		Pool::deallocate(node, sizeof(PooledNode));
+	}
+
+	std::thread rebuilder([&nodes]() {
+		for (unsigned i = 0; i < nodes.size() / 2; i++)
+		{
+			nodes[i] = Pool::allocate(sizeof(PooledNode));
+		}
+		for (unsigned i = 0; i < nodes.size() / 2; i++)
+		{
+			Pool::deallocate(nodes[i], sizeof(PooledNode));
+		}
+	});
+	rebuilder.join();
+	BOOST_CHECK_EQUAL(Pool::getReservedNodes(), reserved);
+}
+
+BOOST_AUTO_TEST_CASE(node_pool_nodes_in_use_test) {
+	// Each thread reports the nodes it allocates and frees in batches: the count is exact once the threads are done
+	std::size_t inUse(Pool::getNodesInUse());
+	std::vector<void*> nodes(10 * Pool::reportedNodes);
+	std::thread builder([&nodes]() {
+		for (auto& node : nodes)
+		{
+			node = Pool::allocate(sizeof(PooledNode));
+		}
+	});
+	builder.join();
+	BOOST_CHECK_EQUAL(Pool::getNodesInUse(), inUse + nodes.size());
+
+	std::thread destroyer([&nodes]() {
+		for (auto node : nodes)
+		{
+			Pool::deallocate(node, sizeof(PooledNode));
+		}
+	});
+	destroyer.join();
+	BOOST_CHECK_EQUAL(Pool::getNodesInUse(), inUse);
+}
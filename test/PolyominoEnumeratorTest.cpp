@@ -0,0 +1,91 @@
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include "PolyominoEnumerator.h"
+#include "Polyomino.h"
+#include "Utilities.h"
+#include <vector>
+#include <set>
+#include <fstream>
+
+using namespace TetrisAI;
+
+BOOST_AUTO_TEST_CASE(polyomino_enumerator_test) {
+	for (int squares = 1; squares <= PolyominoEnumerator::maxSquares; squares++)
+	{
+		std::vector<std::vector<unsigned int>> polyominos(PolyominoEnumerator::enumerate(squares));
+		BOOST_REQUIRE_EQUAL(polyominos.size(), PolyominoEnumerator::getCount(squares));
+
+		// Every polyomino has the right number of squares and no two of them are rotations of each other
+		std::set<std::vector<unsigned int>> rotations;
+		for (auto& content : polyominos)
+		{
+			int blocks(0);
+			for (auto row : content)
+			{
+				blocks += activeBitsCount(row);
+			}
+			BOOST_CHECK_EQUAL(blocks, squares);
+
+			std::set<std::vector<unsigned int>> pieceRotations;
+			PolyominoState state(content);
+			for (int rotation = 0; rotation < 4; rotation++, state = state.getRotatedState())
+			{
+				BOOST_CHECK(!rotations.count(state.getContent()));
+				pieceRotations.insert(state.getContent());
+			}
+			rotations.insert(pieceRotations.begin(), pieceRotations.end());
+		}
+
+		// The catalog lists the same pieces (in other orientations)
+		if (squares <= 5)
+		{
+			for (auto& polyomino : Polyomino::getPolyominosList(squares))
+			{
+				BOOST_CHECK(rotations.count(polyomino.getRotatedPiece(0).getContent()));
+			}
+		}
+	}
+	BOOST_CHECK_THROW(PolyominoEnumerator::enumerate(PolyominoEnumerator::maxSquares + 1), std::invalid_argument);
+	BOOST_CHECK_EQUAL(PolyominoEnumerator::getCount(6), 60);
+	BOOST_CHECK_EQUAL(PolyominoEnumerator::getCount(7), 196);
+}
+BOOST_AUTO_TEST_CASE(polyomino_enumerator_cache_test) {
+	boost::filesystem::path directory(boost::filesystem::temp_directory_path() / boost::filesystem::unique_path());
+	boost::filesystem::create_directories(directory);
+	std::string path(PolyominoEnumerator::getCachePath(6, directory.string()));
+
+	// The first load writes the cache, the next ones read it
+	std::vector<std::vector<unsigned int>> expected(PolyominoEnumerator::enumerate(6));
+	BOOST_CHECK(PolyominoEnumerator::load(6, directory.string()) == expected);
+	BOOST_REQUIRE(boost::filesystem::exists(path));
+	BOOST_CHECK(PolyominoEnumerator::load(6, directory.string()) == expected);
+
+	// A damaged cache file is replaced
+	{
+		std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+		file.seekp(9);
+		file.put(0);
+	}
+	BOOST_CHECK(PolyominoEnumerator::load(6, directory.string()) == expected);
+	boost::filesystem::resize_file(path, 20);
+	BOOST_CHECK(PolyominoEnumerator::load(6, directory.string()) == expected);
+	BOOST_CHECK(PolyominoEnumerator::load(6, directory.string()) == expected);
+
+	boost::filesystem::remove_all(directory);
+}
+BOOST_AUTO_TEST_CASE(polyomino_enumerated_list_test) {
+	// Polyominos of more than 5 squares get the ids following the catalog ones
+	std::vector<Polyomino> hexominos(Polyomino::getPolyominosList(6));
+	BOOST_REQUIRE_EQUAL(hexominos.size(), 60);
+	BOOST_CHECK_EQUAL(Polyomino::getFirstId(6), PolyominoCatalog::size);
+	for (unsigned index = 0; index < hexominos.size(); index++)
+	{
+		BOOST_CHECK_EQUAL(hexominos[index].getId(), Polyomino::getFirstId(6) + index);
+		BOOST_CHECK(Polyomino::fromId(hexominos[index].getId()).getRotatedPiece(0) == hexominos[index].getRotatedPiece(0));
+		BOOST_CHECK_EQUAL(Polyomino(hexominos[index].getRotatedPiece(0).getContent()).getId(), hexominos[index].getId());
+	}
+	if (Polyomino::maxSquares >= 7)
+	{
+		BOOST_CHECK_EQUAL(Polyomino::getPolyominosList(7).size(), 196);
+	}
+}
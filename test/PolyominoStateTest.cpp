@@ -54,4 +54,26 @@ BOOST_AUTO_TEST_CASE(polyominostate_rotation_test) {
 		currentRotation = currentRotation.getRotatedState();
 		BOOST_CHECK(base == currentRotation);
 	}
+}
+
+BOOST_AUTO_TEST_CASE(polyominostate_profiles_test) {
+	/* Piece:
+	1.	xxx
+	0.	-x-
+	*/
+	PolyominoState t({ 2, 7 });
+	std::vector<short> expectedBottom({ 1, 0, 1 }), expectedTop({ 1, 1, 1 });
+	BOOST_CHECK_EQUAL_COLLECTIONS(t.getBottomProfile().begin(), t.getBottomProfile().end(), expectedBottom.begin(), expectedBottom.end());
+	BOOST_CHECK_EQUAL_COLLECTIONS(t.getTopProfile().begin(), t.getTopProfile().end(), expectedTop.begin(), expectedTop.end());
+
+	/* Rotated piece:
+	2.	-x
+	1.	xx
+	0.	-x
+	*/
+	PolyominoState rotated(t.getRotatedState());
+	expectedBottom = std::vector<short>({ 0, 1 });
+	expectedTop = std::vector<short>({ 2, 1 });
+	BOOST_CHECK_EQUAL_COLLECTIONS(rotated.getBottomProfile().begin(), rotated.getBottomProfile().end(), expectedBottom.begin(), expectedBottom.end());
+	BOOST_CHECK_EQUAL_COLLECTIONS(rotated.getTopProfile().begin(), rotated.getTopProfile().end(), expectedTop.begin(), expectedTop.end());
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include <boost/test/unit_test.hpp>
 #include "Polyomino.h"
 #include <vector>
+#include <stdexcept>
 
 using namespace TetrisAI;
 
@@ -27,4 +28,65 @@ BOOST_AUTO_TEST_CASE(polyomino_constructors_test) {
 	BOOST_CHECK(r2 == ps2);
 	BOOST_CHECK(r3 == ps3);
 	BOOST_CHECK(r4 == ps0);
-}
\ No newline at end of file
+}
+BOOST_AUTO_TEST_CASE(polyomino_placed_pieces_test) {
+	// Tetramino L: 4 rotations, each of them translated in every column of the widest grid
+	Polyomino p({ 4, 7 });
+	int expectedCount(0);
+	for (int rotation = 0; rotation < p.getRotationCount(); rotation++)
+	{
+		expectedCount += rowBits - p.getRotatedPiece(rotation).getWidth() + 1;
+	}
+	BOOST_REQUIRE_EQUAL(p.getPlacedPiecesCount(), expectedCount);
+
+	for (int index = 0; index < p.getPlacedPiecesCount(); index++)
+	{
+		const PlacedPiece& piece(p.getPlacedPiece(index));
+		Transformation t(piece.translation, piece.rotation);
+		BOOST_CHECK_EQUAL(p.getPlacedPieceIndex(t), index);
+
+		const PolyominoState& rotatedPiece(p.getRotatedPiece(t.rotation));
+		BOOST_REQUIRE_EQUAL(piece.height, rotatedPiece.getHeight());
+		BOOST_REQUIRE_EQUAL(piece.width, rotatedPiece.getWidth());
+		for (int row = 0; row < piece.height; row++)
+		{
+			BOOST_CHECK_EQUAL(piece.rows[row], Row(rotatedPiece.getContent()[row]) << t.translation);
+		}
+		BOOST_CHECK_EQUAL_COLLECTIONS(piece.bottomProfile.begin(), piece.bottomProfile.begin() + piece.width, rotatedPiece.getBottomProfile().begin(), rotatedPiece.getBottomProfile().end());
+		BOOST_CHECK_EQUAL_COLLECTIONS(piece.topProfile.begin(), piece.topProfile.begin() + piece.width, rotatedPiece.getTopProfile().begin(), rotatedPiece.getTopProfile().end());
+	}
+
+	// Rotations loop like getRotatedPiece, translations must fit in the widest grid
+	BOOST_CHECK_EQUAL(p.getPlacedPieceIndex(Transformation(1, 5)), p.getPlacedPieceIndex(Transformation(1, 1)));
+	BOOST_CHECK_EQUAL(p.getPlacedPieceIndex(Transformation(-1, 0)), -1);
+	BOOST_CHECK_EQUAL(p.getPlacedPieceIndex(Transformation(rowBits - 2, 0)), -1);
+}
+BOOST_AUTO_TEST_CASE(polyomino_catalog_test) {
+	// Rotations computed at compile time must match the ones computed at runtime by PolyominoState
+	for (int id = 0; id < PolyominoCatalog::size; id++)
+	{
+		const Polyomino& p(Polyomino::fromId(id));
+		BOOST_CHECK_EQUAL(p.getId(), id);
+		PolyominoState rotatedState(p.getRotatedPiece(0));
+		for (int rotation = 1; rotation <= p.getRotationCount(); rotation++)
+		{
+			rotatedState = rotatedState.getRotatedState();
+			BOOST_CHECK(rotatedState == p.getRotatedPiece(rotation));
+		}
+	}
+	BOOST_CHECK_THROW(Polyomino::fromId(Polyomino::getFirstId(Polyomino::maxSquares + 1)), std::invalid_argument);
+
+	// Lists are made of copies of the catalog that keep their id
+	for (int squares = 1; squares <= PolyominoShape::maxSize; squares++)
+	{
+		std::vector<Polyomino> list(Polyomino::getPolyominosList(squares));
+		BOOST_REQUIRE_EQUAL(list.size(), PolyominoCatalog::count(squares));
+		for (unsigned index = 0; index < list.size(); index++)
+		{
+			BOOST_CHECK_EQUAL(list[index].getId(), PolyominoCatalog::firstId(squares) + index);
+		}
+	}
+	BOOST_CHECK_EQUAL(Polyomino({ 4, 7 }).getId(), PolyominoCatalog::firstId(4) + 2);
+	BOOST_CHECK_THROW(Polyomino({ 7, 4 }), std::invalid_argument); // Not the base state of the L tetromino
+	BOOST_CHECK_THROW(Polyomino::getPolyominosList(Polyomino::maxSquares + 1), std::invalid_argument);
+}
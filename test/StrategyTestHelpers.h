@@ -0,0 +1,65 @@
+#ifndef TETRISAI_STRATEGYTESTHELPERS_H
+#define TETRISAI_STRATEGYTESTHELPERS_H
+
+#include <boost/test/unit_test.hpp>
+#include <functional>
+#include <memory>
+#include <random>
+#include "GameStateNode.h"
+#include "Heuristic.h"
+
+namespace TetrisAI {
+
+	/// <summary>Plays a game with a strategy and checks every decision against a tree of nodes built from scratch</summary>
+	/// <param name="heuristic">Heuristic of the tree of nodes, which the strategy should use as well</param>
+	/// <param name="makeStrategy">Builds the strategy considering the given number of moves</param>
+	/// <param name="width">Width of the grid</param>
+	/// <param name="height">Height of the grid</param>
+	/// <param name="squares">Number of squares of the polyominos drawn</param>
+	/// <param name="stepsAhead">Number of polyominos known in advance</param>
+	/// <param name="depth">Number of moves considered by the tree and the strategy</param>
+	/// <param name="moves">Number of moves played unless the game is over before</param>
+	/// <param name="seed">Seed of the generator drawing the polyominos</param>
+	/// <param name="checkDecision">Called after each decision matching the tree, with the strategy and the best child of the tree (may be empty)</param>
+	/// <returns>Strategy at the end of the game</returns>
+	template <typename Strategy>
+	std::unique_ptr<Strategy> checkAgainstNodeTree(Heuristic& heuristic, const std::function<std::unique_ptr<Strategy>(unsigned)>& makeStrategy,
+		short width, short height, unsigned squares, unsigned stepsAhead, unsigned depth, unsigned moves, unsigned seed,
+		const std::function<void(Strategy&, DecisionTreeNode&)>& checkDecision = nullptr)
+	{
+		std::mt19937 generator(seed);
+		std::vector<Polyomino> polyominos(Polyomino::getPolyominosList(squares));
+		std::uniform_int_distribution<int> distribution(0, polyominos.size() - 1);
+		std::unique_ptr<Strategy> strategy(makeStrategy(depth));
+
+		GameState gameState(width, height);
+		for (unsigned i = 0; i < stepsAhead; i++)
+		{
+			gameState.addPolyominoToQueue(&polyominos[distribution(generator)]);
+		}
+
+		for (unsigned move = 0; move < moves; move++)
+		{
+			gameState.addPolyominoToQueue(&polyominos[distribution(generator)]);
+			std::unique_ptr<DecisionTreeNode> bestChild(GameStateNode(gameState, depth, polyominos, heuristic).extractBestChild());
+
+			Transformation decision(strategy->decideMove(gameState, polyominos));
+			if (bestChild->isGameOver())
+			{
+				BOOST_CHECK_EQUAL(decision.translation, -1);
+				break;
+			}
+			BOOST_CHECK_EQUAL(decision.translation, bestChild->getPolyominoMove().translation);
+			BOOST_CHECK_EQUAL(decision.rotation, bestChild->getPolyominoMove().rotation);
+			if (checkDecision)
+			{
+				checkDecision(*strategy, *bestChild);
+			}
+			gameState.play(decision);
+		}
+		return strategy;
+	}
+
+}
+
+#endif
@@ -0,0 +1,65 @@
+#include <boost/test/unit_test.hpp>
+#include "ThreadPool.h"
+#include <atomic>
+#include <stdexcept>
+
+using namespace TetrisAI;
+
+namespace {
+
+	/// <summary>Counts the leaves of a complete binary tree of tasks, each node waiting for the tasks of its two children</summary>
+	void countLeaves(ThreadPool& pool, int depth, std::atomic<int>& leaves)
+	{
+		if (depth == 0)
+		{
+			leaves++;
+			return;
+		}
+
+		ThreadPool::TaskGroup children(pool);
+		for (int child = 0; child < 2; child++)
+		{
+			children.run([&pool, depth, &leaves]() { countLeaves(pool, depth - 1, leaves); });
+		}
+		children.wait();
+	}
+}
+
+BOOST_AUTO_TEST_CASE(thread_pool_test) {
+	BOOST_CHECK_THROW(ThreadPool(0), std::invalid_argument);
+
+	ThreadPool pool(3);
+	BOOST_CHECK_EQUAL(pool.getThreadCount(), 4);
+
+	// Tasks waiting for their own subtasks must not block the pool, whatever the number of threads
+	pool.resetStatistics();
+	std::atomic<int> leaves(0);
+	countLeaves(pool, 10, leaves);
+	BOOST_CHECK_EQUAL(leaves, 1024);
+
+	ThreadPool::Statistics statistics(pool.getStatistics());
+	BOOST_CHECK_EQUAL(statistics.tasks, 2046); // Every node of the tree but the root
+	BOOST_CHECK(statistics.steals <= statistics.tasks);
+	BOOST_CHECK(statistics.seconds > 0);
+	BOOST_CHECK(statistics.utilization >= 0 && statistics.utilization <= 1);
+
+	pool.resetStatistics();
+	BOOST_CHECK_EQUAL(pool.getStatistics().tasks, 0);
+
+	// The first exception thrown by a task is rethrown by wait, once every task of the group is done
+	std::atomic<int> done(0);
+	ThreadPool::TaskGroup group(pool);
+	for (int i = 0; i < 8; i++)
+	{
+		group.run([i, &done]() {
+			done++;
+			if (i % 2)
+			{
+				throw std::runtime_error("Task failure");
+			}
+		});
+	}
+	BOOST_CHECK_THROW(group.wait(), std::runtime_error);
+	BOOST_CHECK_EQUAL(done, 8);
+	group.wait(); // The exception was handed over
+}
@@ -0,0 +1,67 @@
+#include <boost/test/unit_test.hpp>
+#include "TranspositionTable.h"
+#include "GameStateNode.h"
+#include "DellacherieHeuristic.h"
+#include <random>
+#include <stdexcept>
+
+using namespace TetrisAI;
+
+BOOST_AUTO_TEST_CASE(transposition_table_test) {
+	BOOST_CHECK_THROW(TranspositionTable(TranspositionTable::maxSizeLog2 + 1), std::invalid_argument);
+
+	TranspositionTable table(4);
+	float evaluation(0);
+	BOOST_CHECK(!table.probe(0, 0, evaluation)); // An empty entry must not match the null hash
+	BOOST_CHECK(!table.probe(42, 2, evaluation));
+
+	table.store(42, 2, -3.5f);
+	BOOST_CHECK(table.probe(42, 2, evaluation));
+	BOOST_CHECK_EQUAL(evaluation, -3.5f);
+	BOOST_CHECK(!table.probe(42, 3, evaluation)); // Same position considered with another depth
+	BOOST_CHECK(!table.probe(42 + 16, 2, evaluation)); // Another position sharing the same slot
+
+	// A position stored in the same slot replaces the previous one
+	table.store(42 + 16, 2, 7.0f);
+	BOOST_CHECK(table.probe(42 + 16, 2, evaluation));
+	BOOST_CHECK_EQUAL(evaluation, 7.0f);
+	BOOST_CHECK(!table.probe(42, 2, evaluation));
+
+	BOOST_CHECK_EQUAL(table.getStores(), 2);
+	BOOST_CHECK_EQUAL(table.getProbes(), 7);
+	BOOST_CHECK_EQUAL(table.getHits(), 2);
+	BOOST_CHECK_CLOSE(table.getHitRate(), 2.0 / 7, 1e-9);
+
+	table.clear();
+	BOOST_CHECK(!table.probe(42 + 16, 2, evaluation));
+	BOOST_CHECK_EQUAL(table.getProbes(), 1);
+	BOOST_CHECK_EQUAL(table.getHits(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(transposition_table_unknown_polyomino_test) {
+	// Positions reached through moves clearing lines differently must not share their evaluation when the next polyomino is unknown
+	std::vector<Polyomino> triominos(Polyomino::getPolyominosList(3));
+	DellacherieHeuristic heuristic;
+	TranspositionTable table(16);
+	std::mt19937 generator(7);
+	int depth(3);
+
+	GameState gameState(6, 10);
+	for (unsigned move = 0; move < 40; move++)
+	{
+		gameState.addPolyominoToQueue(&triominos[generator() % triominos.size()]);
+		GameStateNode tree(gameState, depth, SearchContext(triominos, heuristic));
+		GameStateNode sharedTree(gameState, depth, SearchContext(triominos, heuristic, &table));
+		BOOST_CHECK_EQUAL(tree.getNodeEvaluation(), sharedTree.getNodeEvaluation());
+
+		std::unique_ptr<DecisionTreeNode> bestChild(tree.extractBestChild()), sharedBestChild(sharedTree.extractBestChild());
+		BOOST_CHECK_EQUAL(bestChild->getPolyominoMove().translation, sharedBestChild->getPolyominoMove().translation);
+		BOOST_CHECK_EQUAL(bestChild->getPolyominoMove().rotation, sharedBestChild->getPolyominoMove().rotation);
+		if (bestChild->isGameOver())
+		{
+			break;
+		}
+		gameState.play(bestChild->getPolyominoMove());
+	}
+	BOOST_CHECK(table.getHits() > 0);
+}